@@ -0,0 +1,566 @@
+/*-----------------------------------------------------------------------------
+File name : check.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Program that checks the guarantees given in the headers of the
+ engine: the error of the trigonometry of fasttrig.h against libm over the
+ angles of the robots, the frames of the simulation step that add no state
+ allocating nothing once the simulation runs and those that add one only
+ allocating the explosion times of the new particles, but for the seldom
+ growth of the lists, the two step modes giving
+ the same timeline with many robots in contact, a fork without edit of a
+ timeline or of a checkpoint giving the states of the run it comes from,
+ the timelines of every mode following the rules checked by the validator,
+ the exact and float modes exploding the particles at the same frames, and
+ the parallel loops and task groups of the task pool.
+ With -t only the task pool is checked, the run of the DEEPCLEANER_TSAN build.
+
+Command line arguments: DeepCleaner_Check [-s <Seed>] [-t]
+Exit code: 0 if every check passes, 1 otherwise
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "fasttrig.h"
+#include "generator.h"
+#include "simulation.h"
+#include "taskpool.h"
+#include "trajectory.h"
+#include "validator.h"
+
+using namespace std;
+const int PASSED = 0, FAILED = 1;
+
+// Bound documented in fasttrig.h
+const double TRIG_TOLERANCE = 1e-15;
+const int TRIG_SAMPLES = 1000000;
+const double COORDINATE_RANGE = 2000.0; // pixels, relative positions of the bodies
+
+// Frames simulated before counting, the pools and the arena fill up
+const int WARM_UP_FRAMES = 500;
+const int COUNTED_FRAMES = 2000;
+// The lists of the engine, the route planner and the timeline double when
+// full, at most one frame adding a state in so many grows one
+const int GROWTH_FRAME_RATIO = 8;
+
+// Scenario of the forks, enough robots to collide with each other
+const int FORK_ROBOTS = 30;
+const int FORK_PARTICLES = 200;
+
+// Explosions on the frame boundaries. A sixteenth of a second is a double,
+// the float timer is then exact and the two time modes can be compared
+const int EXPLOSION_FPS = 16;
+const int EXPLOSION_FRAMES = 6;
+const double EXPLOSION_DISTANCE = 1000.0; // pixels, the robot reaches none
+
+// Crowded scenario of the step modes, many robots touch each other and eat
+// the same particles in a frame
+const int CROWD_ROBOTS = 60;
+const int CROWD_PARTICLES = 120;
+
+// Task pool runs, more threads than most machines have cores
+const unsigned POOL_THREADS = 8;
+const size_t POOL_INDICES = 1000000;
+const size_t NESTED_LOOPS = 64;
+const size_t NESTED_INDICES = 1000;
+const int POOL_ROUNDS = 20;
+
+// Every allocation of the program, counted while enabled
+atomic<bool> countAllocations{false};
+atomic<uint64_t> allocations{0};
+
+void *operator new(size_t size) {
+    if (countAllocations.load(memory_order_relaxed))
+        allocations.fetch_add(1, memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+bool report(const string &name, bool passed, const string &detail);
+
+// The robots and particles of both states are the same
+bool sameBodies(const State &a, const State &b);
+
+bool checkSinCos(mt19937_64 &random);
+
+bool checkAtan2(mt19937_64 &random);
+
+// Frames of the step adding no state allocate nothing, those adding one only
+// the explosion times of the new particles: the list, one vector by level and
+// the shared block. The growth of the lists is counted apart
+bool checkStepAllocations(const Scenario &scenario, StepMode stepMode,
+                          TargetMode targetMode, const string &name);
+
+// The legacy and the two phase steps simulate the same timeline. Crowded, the
+// robots must also touch each other in it
+bool checkStepModes(const Scenario &scenario, const string &name, bool crowded);
+
+// A fork of the middle state without edit gives the rest of the timeline, for
+// the timeline and for the checkpoint of the run. The checkpoint fork starts
+// at the frame after the fork state
+bool checkFork(const Scenario &scenario, StepMode stepMode, TargetMode targetMode,
+               const string &name);
+
+// The particles explode at the same frames in exact and float mode, the
+// first frame reaching their time minus the tolerance
+bool checkExplosionFrames();
+
+// The timeline simulated with the given modes has no violation
+template <SimConfig Config>
+bool checkValid(const Scenario &scenario, const Config &config, StepMode stepMode,
+                MoveMode moveMode, TargetMode targetMode, const string &name);
+
+// Every index of the parallel loops, nested or not, runs once and the errors
+// of the tasks reach the waiting thread
+bool checkTaskPool(TaskPool &pool, const string &name);
+
+int main(int argc, char *argv[]) {
+    uint64_t seed = 1;
+    bool poolOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-s" && i + 1 < argc) {
+            try {
+                seed = stoull(argv[++i]);
+            }
+            catch (exception &) {
+                cerr << "Invalid seed '" << argv[i] << "'\n";
+                return FAILED;
+            }
+        } else if (arg == "-t") {
+            poolOnly = true;
+        } else {
+            cerr << "Usage: DeepCleaner_Check [-s <Seed>] [-t]\n";
+            return FAILED;
+        }
+    }
+
+    try {
+        TaskPool pool(POOL_THREADS);
+        bool poolPassed = checkTaskPool(pool, "pool of " + to_string(POOL_THREADS)
+                                              + " threads");
+        poolPassed = checkTaskPool(TaskPool::shared(), "shared pool") && poolPassed;
+        if (poolOnly) {
+            cout << (poolPassed ? "All checks passed\n" : "Some checks failed\n");
+            return poolPassed ? PASSED : FAILED;
+        }
+
+        mt19937_64 random(seed);
+        bool passed = checkSinCos(random) && poolPassed;
+        passed = checkAtan2(random) && passed;
+
+        ScenarioParameters parameters;
+        parameters.seed = seed;
+        Scenario scenario = generateScenario(parameters);
+        passed = checkStepAllocations(scenario, LEGACY_STEP, NEAREST_TARGET,
+                                      "legacy step, nearest targets") && passed;
+        passed = checkStepAllocations(scenario, LEGACY_STEP, ROUTED_TARGETS,
+                                      "legacy step, routed targets") && passed;
+        passed = checkStepAllocations(scenario, TWO_PHASE_STEP, NEAREST_TARGET,
+                                      "two phase step, nearest targets") && passed;
+        passed = checkStepAllocations(scenario, TWO_PHASE_STEP, ROUTED_TARGETS,
+                                      "two phase step, routed targets") && passed;
+        passed = checkStepModes(scenario, "default scenario", false) && passed;
+
+        parameters.robotCount = CROWD_ROBOTS;
+        parameters.particleCount = CROWD_PARTICLES;
+        Scenario crowdedScenario = generateScenario(parameters);
+        passed = checkStepModes(crowdedScenario, "crowded scenario", true) && passed;
+
+        parameters.robotCount = FORK_ROBOTS;
+        parameters.particleCount = FORK_PARTICLES;
+        Scenario forkScenario = generateScenario(parameters);
+        passed = checkFork(forkScenario, LEGACY_STEP, NEAREST_TARGET,
+                           "legacy step, nearest targets") && passed;
+        passed = checkFork(forkScenario, TWO_PHASE_STEP, NEAREST_TARGET,
+                           "two phase step, nearest targets") && passed;
+        passed = checkFork(forkScenario, LEGACY_STEP, ROUTED_TARGETS,
+                           "legacy step, routed targets") && passed;
+
+        passed = checkExplosionFrames() && passed;
+        passed = checkValid(forkScenario, DefaultSimConfig(), LEGACY_STEP,
+                            TURN_AND_GO, NEAREST_TARGET, "legacy step") && passed;
+        passed = checkValid(forkScenario, ExactSimConfig(), LEGACY_STEP,
+                            TURN_AND_GO, NEAREST_TARGET, "exact mode") && passed;
+        passed = checkValid(forkScenario, DefaultSimConfig(), TWO_PHASE_STEP,
+                            TURN_AND_GO, NEAREST_TARGET, "two phase step") && passed;
+        passed = checkValid(forkScenario, DefaultSimConfig(), LEGACY_STEP,
+                            TURN_AND_GO, ROUTED_TARGETS, "routed targets") && passed;
+        passed = checkValid(forkScenario, DefaultSimConfig(), LEGACY_STEP,
+                            ARC_MOVES, NEAREST_TARGET, "arc moves") && passed;
+
+        cout << (passed ? "All checks passed\n" : "Some checks failed\n");
+        return passed ? PASSED : FAILED;
+    }
+    catch (exception &e) {
+        cerr << "Exception occurred : " << e.what() << '\n';
+        return FAILED;
+    }
+}
+
+bool report(const string &name, bool passed, const string &detail) {
+    cout << (passed ? "[ OK ] " : "[FAIL] ") << name << ": " << detail << '\n';
+    return passed;
+}
+
+bool checkSinCos(mt19937_64 &random) {
+    uniform_real_distribution<double> angles(-2 * M_PI, 2 * M_PI);
+    vector<double> batch(TRIG_SAMPLES);
+    for (double &angle: batch)
+        angle = angles(random);
+    // The quarter turns, where the quadrant changes
+    for (int k = -4; k <= 4; ++k)
+        batch.push_back(k * M_PI_2);
+    vector<SinCos> batchResults(batch.size());
+    sinCosBatch(batch, batchResults);
+
+    double error = 0;
+    bool sameAsBatch = true;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        SinCos result = fastSinCos(batch[i]);
+        error = max({error, abs(result.sine - sin(batch[i])),
+                     abs(result.cosine - cos(batch[i]))});
+        sameAsBatch = sameAsBatch && result.sine == batchResults[i].sine
+                      && result.cosine == batchResults[i].cosine;
+    }
+    bool passed = report("fastSinCos over [-2pi, 2pi]", error <= TRIG_TOLERANCE,
+                         "max error " + to_string(error * 1e15) + "e-15");
+    return report("sinCosBatch", sameAsBatch, "same values as one by one") && passed;
+}
+
+bool checkAtan2(mt19937_64 &random) {
+    uniform_real_distribution<double> coordinates(-COORDINATE_RANGE, COORDINATE_RANGE);
+    vector<double> ys(TRIG_SAMPLES), xs(TRIG_SAMPLES);
+    for (int i = 0; i < TRIG_SAMPLES; ++i) {
+        ys[i] = coordinates(random);
+        xs[i] = coordinates(random);
+        // The axes and the diagonals, where the reductions change
+        if (i % 7 == 0)
+            ys[i] = 0;
+        if (i % 11 == 0)
+            xs[i] = 0;
+        if (i % 13 == 0)
+            ys[i] = xs[i];
+        if (i % 17 == 0)
+            ys[i] = -xs[i];
+    }
+    vector<double> batchResults(ys.size());
+    atan2Batch(ys, xs, batchResults);
+
+    double error = 0;
+    bool inRange = true, sameAsBatch = true;
+    for (size_t i = 0; i < ys.size(); ++i) {
+        double angle = fastAtan2(ys[i], xs[i]);
+        // -pi and pi are the same direction
+        error = max(error, abs(remainder(angle - atan2(ys[i], xs[i]), 2 * M_PI)));
+        inRange = inRange && angle > -M_PI && angle <= M_PI;
+        sameAsBatch = sameAsBatch && angle == batchResults[i];
+    }
+    inRange = inRange && fastAtan2(0, 0) == 0;
+    bool passed = report("fastAtan2", error <= TRIG_TOLERANCE,
+                         "max error " + to_string(error * 1e15) + "e-15 rad");
+    passed = report("fastAtan2 range", inRange, "in ]-pi, pi], 0 for (0, 0)")
+             && passed;
+    return report("atan2Batch", sameAsBatch, "same values as one by one") && passed;
+}
+
+bool checkStepAllocations(const Scenario &scenario, StepMode stepMode,
+                          TargetMode targetMode, const string &name) {
+    Simulation simulation(scenario.state, scenario.constraints);
+    simulation.setStepMode(stepMode);
+    simulation.setTargetMode(targetMode);
+    for (int i = 0; i < WARM_UP_FRAMES && !simulation.isFinished(); ++i)
+        simulation.step();
+
+    int frames = 0, allocatingFrames = 0, stateFrames = 0, growthFrames = 0;
+    uint64_t frameAllocations = 0, growthAllocations = 0;
+    vector<int> previousIds;
+    for (int i = 0; i < COUNTED_FRAMES && !simulation.isFinished(); ++i) {
+        previousIds.clear();
+        for (const Particle &p: simulation.getTimeline().getStates().back().getParticles())
+            previousIds.push_back(p.getId());
+        sort(previousIds.begin(), previousIds.end());
+        allocations = 0;
+        countAllocations = true;
+        bool added = simulation.step();
+        countAllocations = false;
+        if (!added) {
+            ++frames;
+            frameAllocations += allocations;
+            allocatingFrames += allocations > 0;
+            continue;
+        }
+        uint64_t expected = 0;
+        for (const Particle &p: simulation.getTimeline().getStates().back().getParticles()) {
+            if (!binary_search(previousIds.begin(), previousIds.end(), p.getId()))
+                expected += 2 + p.getExplosionTimes().size();
+        }
+        ++stateFrames;
+        if (allocations > expected) {
+            ++growthFrames;
+            growthAllocations += allocations - expected;
+        }
+    }
+    if (frames == 0 || stateFrames == 0)
+        throw runtime_error("No frame with and without a new state in the scenario");
+    bool passed = report("allocations of the " + name, frameAllocations == 0,
+                         to_string(frameAllocations) + " in " + to_string(allocatingFrames)
+                         + " of " + to_string(frames) + " frames adding no state");
+    return report("allocations of the " + name + " adding states",
+                  growthFrames * GROWTH_FRAME_RATIO <= stateFrames,
+                  to_string(growthAllocations) + " besides the new particles in "
+                  + to_string(growthFrames) + " of " + to_string(stateFrames)
+                  + " frames adding a state") && passed;
+}
+
+bool sameBodies(const State &a, const State &b) {
+    if (a.getTime() != b.getTime() || a.getRobots().size() != b.getRobots().size()
+        || a.getParticles().size() != b.getParticles().size())
+        return false;
+    for (size_t i = 0; i < a.getRobots().size(); ++i) {
+        const Robot &ra = a.getRobots()[i], &rb = b.getRobots()[i];
+        if (ra.getId() != rb.getId()
+            || ra.getPosition().getX() != rb.getPosition().getX()
+            || ra.getPosition().getY() != rb.getPosition().getY()
+            || ra.getAngle() != rb.getAngle() || ra.getScore() != rb.getScore())
+            return false;
+    }
+    for (size_t i = 0; i < a.getParticles().size(); ++i)
+        if (a.getParticles()[i].getId() != b.getParticles()[i].getId())
+            return false;
+    return true;
+}
+
+bool checkStepModes(const Scenario &scenario, const string &name, bool crowded) {
+    Simulation legacy(scenario.state, scenario.constraints);
+    Simulation twoPhase(scenario.state, scenario.constraints);
+    twoPhase.setStepMode(TWO_PHASE_STEP);
+    while (!legacy.isFinished())
+        legacy.step();
+    while (!twoPhase.isFinished())
+        twoPhase.step();
+
+    span<const State> a = legacy.getTimeline().getStates();
+    span<const State> b = twoPhase.getTimeline().getStates();
+    size_t same = 0;
+    while (same < min(a.size(), b.size()) && sameBodies(a[same], b[same]))
+        ++same;
+
+    // Pairs of robots in contact over the states
+    size_t contacts = 0;
+    for (const State &state: a) {
+        const RobotList &robots = state.getRobots();
+        for (size_t i = 0; i < robots.size(); ++i)
+            for (size_t j = i + 1; j < robots.size(); ++j)
+                contacts += detectCollision(robots[i].getPosition(),
+                                            robots[i].getRadius(),
+                                            robots[j].getPosition(),
+                                            robots[j].getRadius(),
+                                            DefaultSimConfig::collisionEpsilon);
+    }
+    return report("legacy and two phase steps of the " + name,
+                  same == a.size() && same == b.size() && (contacts > 0 || !crowded),
+                  to_string(same) + " same states of " + to_string(a.size())
+                  + " and " + to_string(b.size()) + ", " + to_string(contacts)
+                  + " robot contacts");
+}
+
+// Length of the same states at the start of both
+size_t sameLength(span<const State> a, span<const State> b) {
+    size_t same = 0;
+    while (same < min(a.size(), b.size()) && sameBodies(a[same], b[same]))
+        ++same;
+    return same;
+}
+
+bool checkFork(const Scenario &scenario, StepMode stepMode, TargetMode targetMode,
+               const string &name) {
+    Simulation simulation(scenario.state, scenario.constraints);
+    simulation.setStepMode(stepMode);
+    simulation.setTargetMode(targetMode);
+    simulation.setRecordEngine(true);
+    while (!simulation.isFinished())
+        simulation.step();
+    span<const State> states = simulation.getTimeline().getStates();
+    size_t index = states.size() / 2;
+    span<const State> original = states.subspan(index + 1);
+    string fork = "fork of the " + name + " at " + to_string(states[index].getTime())
+                  + " sec";
+
+    optional<vector<State>> replayed = simulateFrom(states, index, nullptr,
+                                                    scenario.constraints,
+                                                    DefaultSimConfig(), stepMode,
+                                                    TURN_AND_GO, targetMode);
+    bool passed;
+    if (!replayed) {
+        passed = report(fork, false, "the run was not simulated again");
+    } else {
+        size_t same = sameLength(original, *replayed);
+        passed = report(fork, same == original.size() && same == replayed->size(),
+                        to_string(same) + " same states of " + to_string(original.size())
+                        + " and " + to_string(replayed->size()));
+    }
+
+    // Started from the engine data of the journal, without the states before
+    string path = (filesystem::temp_directory_path()
+                   / ("deepcleaner_check_" + to_string(stepMode) + to_string(targetMode)
+                      + ".chkp")).string();
+    simulation.saveCheckpoint(path);
+    int64_t startFrame = Simulation(path, index).getFrame();
+    vector<State> resumed = simulateFrom(path, index, nullptr);
+    filesystem::remove(path);
+    filesystem::remove(path + ".states");
+    size_t same = sameLength(original, resumed);
+    bool suffixOnly = startFrame == llround(states[index].getTime()
+                                            * DefaultSimConfig::framePerSec) + 1;
+    return report(fork + " of the checkpoint",
+                  suffixOnly && same == original.size() && same == resumed.size(),
+                  "started at frame " + to_string(startFrame) + ", "
+                  + to_string(same) + " same states of " + to_string(original.size())
+                  + " and " + to_string(resumed.size())) && passed;
+}
+
+// Frame of the first state without each particle, -1 if it never goes
+vector<int64_t> explosionFrames(const State &base, bool exact) {
+    RuntimeSimConfig config(EXPLOSION_FPS, exact);
+    BasicSimulation<RuntimeSimConfig> simulation(base, Constraints(), BASE_STATE,
+                                                 config);
+    while (!simulation.isFinished())
+        simulation.step();
+
+    const ParticleList &particles = base.getParticles();
+    vector<int64_t> frames(particles.size(), -1);
+    for (const State &state: simulation.getTimeline().getStates()) {
+        for (size_t i = 0; i < particles.size(); ++i) {
+            bool present = any_of(state.getParticles().begin(),
+                                  state.getParticles().end(), [&](const Particle &p) {
+                                      return p.getId() == particles[i].getId();
+                                  });
+            if (!present && frames[i] == -1)
+                frames[i] = llround(state.getTime() * EXPLOSION_FPS);
+        }
+    }
+    return frames;
+}
+
+bool checkExplosionFrames() {
+    // On the frame and one tolerance after it, where both modes must explode
+    // at the frame, and further, at the next frame
+    double tolerance = DefaultSimConfig::explosionTolerance;
+    const double offsets[] = {0.0, tolerance, 1.5 * tolerance};
+    vector<Particle> particles;
+    vector<int64_t> expected;
+    for (int frame = 1; frame <= EXPLOSION_FRAMES; ++frame) {
+        for (double offset: offsets) {
+            double time = double(frame) / EXPLOSION_FPS + offset;
+            particles.emplace_back(int(particles.size()),
+                                   Position(EXPLOSION_DISTANCE,
+                                            EXPLOSION_DISTANCE + 20.0 * particles.size()),
+                                   5.0, ExplosionTimes{{time}});
+            expected.push_back(offset > tolerance ? frame + 1 : frame);
+        }
+    }
+    vector<Robot> robots{Robot(0, Position(0, 0), 12.5, 0, 0.2, 0, 0)};
+    State base(0, Position(-EXPLOSION_DISTANCE, -EXPLOSION_DISTANCE),
+               Position(3 * EXPLOSION_DISTANCE, 3 * EXPLOSION_DISTANCE), robots,
+               particles);
+
+    vector<int64_t> exact = explosionFrames(base, true);
+    vector<int64_t> floating = explosionFrames(base, false);
+    size_t wrongExact = 0, wrongFloat = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        wrongExact += exact[i] != expected[i];
+        wrongFloat += floating[i] != expected[i];
+    }
+    return report("explosions on the frame boundaries", wrongExact == 0
+                  && wrongFloat == 0, to_string(wrongExact) + " exact and "
+                  + to_string(wrongFloat) + " float explosions off their frame of "
+                  + to_string(expected.size()));
+}
+
+template <SimConfig Config>
+bool checkValid(const Scenario &scenario, const Config &config, StepMode stepMode,
+                MoveMode moveMode, TargetMode targetMode, const string &name) {
+    BasicSimulation<Config> simulation(scenario.state, scenario.constraints,
+                                       BASE_STATE, config);
+    simulation.setStepMode(stepMode);
+    simulation.setMoveMode(moveMode);
+    simulation.setTargetMode(targetMode);
+    while (!simulation.isFinished())
+        simulation.step();
+
+    span<const State> states = simulation.getTimeline().getStates();
+    vector<Violation> violations = validateTimeline(
+            states, scenario.constraints,
+            RuntimeSimConfig(config.framePerSec, config.exact));
+    string detail = to_string(violations.size()) + " violations in "
+                    + to_string(states.size()) + " states";
+    if (!violations.empty())
+        detail += ", the first one " + violationName(violations.front().type)
+                  + " of robot " + to_string(violations.front().id) + " at "
+                  + to_string(violations.front().time) + " sec";
+    return report("validation of the " + name, violations.empty(), detail);
+}
+
+bool checkTaskPool(TaskPool &pool, const string &name) {
+    size_t wrongLoops = 0, wrongNested = 0, lostErrors = 0;
+    vector<int> runs(POOL_INDICES);
+    for (int round = 0; round < POOL_ROUNDS; ++round) {
+        fill(runs.begin(), runs.end(), 0);
+        pool.parallelFor(runs.size(), [&](size_t i) { ++runs[i]; });
+        wrongLoops += size_t(count_if(runs.begin(), runs.end(),
+                                      [](int n) { return n != 1; }));
+
+        // Loops in the tasks of a loop, the waiting workers run the inner ones
+        atomic<size_t> nested{0};
+        pool.parallelFor(NESTED_LOOPS, [&](size_t) {
+            pool.parallelFor(NESTED_INDICES, [&](size_t) {
+                nested.fetch_add(1, memory_order_relaxed);
+            });
+        });
+        wrongNested += nested != NESTED_LOOPS * NESTED_INDICES;
+
+        // A group destroyed right after its wait, one task throwing
+        try {
+            TaskGroup group(pool);
+            atomic<size_t> done{0};
+            for (size_t i = 0; i < NESTED_LOOPS; ++i)
+                group.run([&done, i]() {
+                    if (i == NESTED_LOOPS / 2)
+                        throw runtime_error("task error");
+                    done.fetch_add(1, memory_order_relaxed);
+                });
+            group.wait();
+            ++lostErrors;
+        }
+        catch (runtime_error &) {
+        }
+    }
+    bool passed = report("parallelFor of the " + name, wrongLoops == 0,
+                         to_string(wrongLoops) + " indices not run once in "
+                         + to_string(POOL_ROUNDS) + " rounds");
+    passed = report("nested parallelFor of the " + name, wrongNested == 0,
+                    to_string(wrongNested) + " wrong totals in "
+                    + to_string(POOL_ROUNDS) + " rounds") && passed;
+    return report("task groups of the " + name, lostErrors == 0,
+                  to_string(lostErrors) + " errors not thrown by wait in "
+                  + to_string(POOL_ROUNDS) + " rounds") && passed;
+}
@@ -0,0 +1,205 @@
+/*-----------------------------------------------------------------------------
+File name : costmatrix.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the cache of the robot to particle costs. The
+simulation removes the particles without changing the order of the others and
+adds the new ones at the end, the columns of the remaining particles are
+moved, not computed again.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <limits>
+#include "costmatrix.h"
+#include "fasttrig.h"
+#include "trajectory.h"
+#include "utils.h"
+
+void CostMatrix::update(const std::vector<Robot> &robots,
+								const std::vector<Particle> &particles,
+								const Constraints &constraints) {
+	double rotation = std::min(constraints.maxBackwardSpeed, constraints.maxForwardSpeed);
+	if (rotation != rotationSpeed || constraints.maxForwardSpeed != forwardSpeed ||
+		 constraints.commandTimeInterval != commandInterval) {
+		rotationSpeed = rotation;
+		forwardSpeed = constraints.maxForwardSpeed;
+		commandInterval = constraints.commandTimeInterval;
+		std::fill(hasTimes.begin(), hasTimes.end(), 0);
+	}
+
+	bool sameRobots = robots.size() == robotIds.size() &&
+							std::equal(robots.begin(), robots.end(), robotIds.begin(),
+										  [](const Robot &r, int id) { return r.getId() == id; });
+	if (!sameRobots) {
+		// Every value is computed again
+		robotIds.clear();
+		for (const Robot &r: robots)
+			robotIds.push_back(r.getId());
+		poses.assign(robots.size(), Pose());
+		staleRows.assign(robots.size(), 1);
+		particleIds.clear();
+		particlePositions.clear();
+		particleRadii.clear();
+	}
+	for (std::size_t i = 0; i < robots.size(); ++i) {
+		const Robot &r = robots[i];
+		Pose &pose = poses[i];
+		if (sameRobots && pose.position.getX() == r.getPosition().getX() &&
+			 pose.position.getY() == r.getPosition().getY() &&
+			 pose.angle == r.getAngle() && pose.radius == r.getRadius())
+			continue;
+		pose = {r.getPosition(), r.getAngle(), r.getRadius()};
+		staleRows[i] = 1;
+	}
+	remapColumns(particles);
+}
+
+void CostMatrix::remapColumns(const std::vector<Particle> &particles) {
+	auto sameParticle = [this](std::size_t column, const Particle &p) {
+		return particleIds[column] == p.getId() &&
+				 particlePositions[column].getX() == p.getPosition().getX() &&
+				 particlePositions[column].getY() == p.getPosition().getY() &&
+				 particleRadii[column] == p.getRadius();
+	};
+	std::size_t count = particles.size(), oldCount = particleIds.size();
+	bool same = count == oldCount;
+	for (std::size_t j = 0; same && j < count; ++j)
+		same = sameParticle(j, particles[j]);
+	if (same)
+		return;
+
+	// Old column of every particle by id, -1 for a new one
+	oldColumns.clear();
+	reserveFor(oldColumns, oldCount);
+	for (std::size_t j = 0; j < oldCount; ++j)
+		oldColumns.emplace_back(particleIds[j], j);
+	std::sort(oldColumns.begin(), oldColumns.end());
+	reserveFor(source, count);
+	source.assign(count, -1);
+	for (std::size_t j = 0; j < count; ++j) {
+		auto old = std::lower_bound(oldColumns.begin(), oldColumns.end(),
+											 std::make_pair(particles[j].getId(), std::size_t(0)));
+		if (old != oldColumns.end() && old->first == particles[j].getId() &&
+			 sameParticle(old->second, particles[j]))
+			source[j] = long(old->second);
+	}
+
+	// The buffers of the previous values are kept, a frame that changes the
+	// particles does not allocate once they are large enough
+	std::size_t rows = poses.size();
+	reserveFor(newDistances, rows * count);
+	reserveFor(newRotations, rows * count);
+	reserveFor(newLines, rows * count);
+	reserveFor(newHasTimes, rows * count);
+	newDistances.resize(rows * count);
+	newRotations.resize(rows * count);
+	newLines.resize(rows * count);
+	newHasTimes.assign(rows * count, 0);
+	for (std::size_t i = 0; i < rows; ++i) {
+		if (staleRows[i])
+			continue;
+		for (std::size_t j = 0; j < count; ++j) {
+			std::size_t to = i * count + j;
+			if (source[j] == -1) {
+				newDistances[to] = linearDistance(poses[i].position,
+															 particles[j].getPosition());
+				continue;
+			}
+			std::size_t from = i * oldCount + std::size_t(source[j]);
+			newDistances[to] = distances[from];
+			newRotations[to] = rotationTimes[from];
+			newLines[to] = lineTimes[from];
+			newHasTimes[to] = hasTimes[from];
+		}
+	}
+	distances.swap(newDistances);
+	rotationTimes.swap(newRotations);
+	lineTimes.swap(newLines);
+	hasTimes.swap(newHasTimes);
+
+	reserveFor(particleIds, count);
+	reserveFor(particlePositions, count);
+	reserveFor(particleRadii, count);
+	particleIds.resize(count);
+	particlePositions.resize(count);
+	particleRadii.resize(count);
+	for (std::size_t j = 0; j < count; ++j) {
+		particleIds[j] = particles[j].getId();
+		particlePositions[j] = particles[j].getPosition();
+		particleRadii[j] = particles[j].getRadius();
+	}
+}
+
+void CostMatrix::computeRow(std::size_t robot) const {
+	const Position &position = poses[robot].position;
+	for (std::size_t j = 0; j < particleIds.size(); ++j) {
+		distances[at(robot, j)] = linearDistance(position, particlePositions[j]);
+		hasTimes[at(robot, j)] = 0;
+	}
+	staleRows[robot] = 0;
+}
+
+void CostMatrix::computeTimes(std::size_t robot, std::size_t particle) const {
+	const Pose &pose = poses[robot];
+	const Position &target = particlePositions[particle];
+	std::size_t index = at(robot, particle);
+	double reach = pose.radius + particleRadii[particle];
+	double rotation = 0.0, line = 0.0;
+	if (distances[index] > reach) {
+		// Same trigonometry as the moves of the engine
+		double direction = fastAtan2(target.getY() - pose.position.getY(),
+											  target.getX() - pose.position.getX());
+		double turn = std::abs(std::remainder(direction - pose.angle, 2 * M_PI));
+		if (turn > angleTolerance)
+			rotation = turn * pose.radius / rotationSpeed;
+		line = (distances[index] - reach) / forwardSpeed;
+	}
+	rotationTimes[index] = rotation;
+	lineTimes[index] = line;
+	hasTimes[index] = 1;
+}
+
+double CostMatrix::getDistance(std::size_t robot, std::size_t particle) const {
+	if (staleRows[robot])
+		computeRow(robot);
+	return distances[at(robot, particle)];
+}
+
+double CostMatrix::getRotationTime(std::size_t robot, std::size_t particle) const {
+	if (staleRows[robot])
+		computeRow(robot);
+	if (!hasTimes[at(robot, particle)])
+		computeTimes(robot, particle);
+	return rotationTimes[at(robot, particle)];
+}
+
+double CostMatrix::getLineTime(std::size_t robot, std::size_t particle) const {
+	if (staleRows[robot])
+		computeRow(robot);
+	if (!hasTimes[at(robot, particle)])
+		computeTimes(robot, particle);
+	return lineTimes[at(robot, particle)];
+}
+
+double CostMatrix::getCaptureTime(std::size_t robot, std::size_t particle) const {
+	return commandDuration(getRotationTime(robot, particle), commandInterval) +
+			 commandDuration(getLineTime(robot, particle), commandInterval);
+}
+
+long CostMatrix::findNearest(std::size_t robot, int excludedId) const {
+	if (staleRows[robot])
+		computeRow(robot);
+	long nearest = -1;
+	double best = std::numeric_limits<double>::max();
+	const double *row = distances.data() + at(robot, 0);
+	for (std::size_t j = 0; j < particleIds.size(); ++j) {
+		if (particleIds[j] == excludedId)
+			continue;
+		if (row[j] <= best) {
+			nearest = long(j);
+			best = row[j];
+		}
+	}
+	return nearest;
+}
@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------------------
+File name : costmatrix.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the cache of the robot to particle costs used by the
+target choices. A row holds the distances from a robot to every particle, a
+column follows a particle. After a frame only the rows of the robots that
+moved and the columns of the new particles are computed again, and the
+capture times, which need the trigonometry, only when they are read.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef COSTMATRIX_H
+#define COSTMATRIX_H
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "particle.h"
+#include "robot.h"
+#include "simconfig.h"
+#include "timeline.h"
+
+// Duration rounded up to whole command intervals, a move ends at a command time
+inline double commandDuration(double duration, double interval) {
+	if (interval <= 0)
+		return duration;
+	return std::ceil(duration / interval - 1e-6) * interval;
+}
+
+class CostMatrix {
+
+public:
+	// The engine gives the tolerance of its configuration (rad), a robot
+	// facing a particle within it does not turn
+	explicit CostMatrix(double angleTolerance = DefaultSimConfig::angleTolerance)
+		: angleTolerance(angleTolerance) {}
+
+	// Rows in the order of the robots, columns in the order of the particles.
+	// The values of the robots and the particles that did not change are kept
+	void update(const std::vector<Robot> &robots,
+					const std::vector<Particle> &particles,
+					const Constraints &constraints);
+
+	double getAngleTolerance() const { return angleTolerance; }
+
+	std::size_t getRobotCount() const { return poses.size(); }
+
+	std::size_t getParticleCount() const { return particleIds.size(); }
+
+	int getParticleId(std::size_t particle) const { return particleIds[particle]; }
+
+	// Between the centers, as linearDistance
+	double getDistance(std::size_t robot, std::size_t particle) const;
+
+	// Time for the robot to turn toward the particle then go in contact with
+	// it, each rounded up to command intervals
+	double getCaptureTime(std::size_t robot, std::size_t particle) const;
+
+	// Parts of the capture time, not rounded (sec)
+	double getRotationTime(std::size_t robot, std::size_t particle) const;
+
+	double getLineTime(std::size_t robot, std::size_t particle) const;
+
+	// Column of the nearest particle other than excludedId, -1 if none. The
+	// last one of equal distances, like the original search
+	long findNearest(std::size_t robot, int excludedId = -1) const;
+
+private:
+	struct Pose {
+		Position position;
+		double angle = 0.0; // rad
+		double radius = 0.0;
+	};
+
+	std::vector<int> robotIds;
+	std::vector<Pose> poses;
+	std::vector<int> particleIds;
+	std::vector<Position> particlePositions;
+	std::vector<double> particleRadii;
+	double rotationSpeed = 0.0;
+	double forwardSpeed = 0.0;
+	double commandInterval = 0.0;
+	double angleTolerance;
+
+	// Robots by particles, computed on the first access after a change
+	mutable std::vector<double> distances;
+	mutable std::vector<double> rotationTimes;
+	mutable std::vector<double> lineTimes;
+	mutable std::vector<char> hasTimes;
+	mutable std::vector<char> staleRows;
+
+	// Reused by remapColumns
+	std::vector<std::pair<int, std::size_t>> oldColumns;
+	std::vector<long> source;
+	std::vector<double> newDistances;
+	std::vector<double> newRotations;
+	std::vector<double> newLines;
+	std::vector<char> newHasTimes;
+
+	void remapColumns(const std::vector<Particle> &particles);
+
+	void computeRow(std::size_t robot) const;
+
+	void computeTimes(std::size_t robot, std::size_t particle) const;
+
+	std::size_t at(std::size_t robot, std::size_t particle) const {
+		return robot * particleIds.size() + particle;
+	}
+};
+
+#endif // COSTMATRIX_H
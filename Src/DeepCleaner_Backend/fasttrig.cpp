@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------------------
+File name : fasttrig.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the trigonometry of the robot moves. The sine
+and cosine reduce the angle to a quarter turn around a multiple of pi/2 and
+use the Cephes polynomials, the arc tangent reduces the ratio below
+tan(pi/8) and uses the Cephes rational function. The quadrants are chosen by
+selections rather than branches, so the loops of the batches vectorize.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include "fasttrig.h"
+
+#ifdef WITH_FAST_TRIG
+
+// pi/2 in two parts, the first one exact when multiplied by a small integer
+const double PI_2_HIGH = 1.57079632673412561417e+00;
+const double PI_2_LOW = 6.07710050650619224932e-11;
+// Added then removed, rounds to an integer kept in the low bits
+const double ROUNDING = 6755399441055744.0; // 1.5 * 2^52
+const double TAN_PI_8 = 0.41421356237309504880;
+
+static inline SinCos sinCosKernel(double angle) {
+	double sum = angle * M_2_PI + ROUNDING;
+	auto quadrant = std::bit_cast<std::uint64_t>(sum);
+	double k = sum - ROUNDING;
+	double x = (angle - k * PI_2_HIGH) - k * PI_2_LOW;
+
+	double z = x * x;
+	double sine = ((((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z
+							 + 2.75573136213857245213e-6) * z - 1.98412698295895385996e-4) * z
+						  + 8.33333333332211858878e-3) * z - 1.66666666666666307295e-1) * z) * x
+					  + x;
+	double cosine = (((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z
+							  - 2.75573141792967388112e-7) * z + 2.48015872888517045348e-5) * z
+							- 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2) * z * z
+						 - 0.5 * z + 1.0;
+
+	bool odd = quadrant & 1;
+	double s = odd ? cosine : sine;
+	double c = odd ? sine : cosine;
+	return {quadrant & 2 ? -s : s, (quadrant + 1) & 2 ? -c : c};
+}
+
+static inline double atan2Kernel(double y, double x) {
+	double ax = std::abs(x), ay = std::abs(y);
+	double high = ax > ay ? ax : ay;
+	double low = ax > ay ? ay : ax;
+	double t = high > 0 ? low / high : 0.0;
+
+	// atan(t) = pi/4 + atan((t - 1) / (t + 1))
+	bool reduced = t > TAN_PI_8;
+	t = reduced ? (t - 1) / (t + 1) : t;
+	double z = t * t;
+	double p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z
+					 - 7.500855792314704667340e1) * z - 1.228866684490136173410e2) * z
+				  - 6.485021904942025371773e1;
+	double q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z
+					 + 4.328810604912902668951e2) * z + 4.853903996359136964868e2) * z
+				  + 1.945506571482613964425e2;
+	double angle = t * z * p / q + t;
+	angle = reduced ? angle + M_PI_4 : angle;
+
+	angle = ay > ax ? M_PI_2 - angle : angle;
+	angle = x < 0 ? M_PI - angle : angle;
+	return y < 0 ? -angle : angle;
+}
+
+#else
+
+static inline SinCos sinCosKernel(double angle) {
+	return {std::sin(angle), std::cos(angle)};
+}
+
+static inline double atan2Kernel(double y, double x) {
+	return std::atan2(y, x);
+}
+
+#endif
+
+SinCos fastSinCos(double angle) {
+	return sinCosKernel(angle);
+}
+
+double fastAtan2(double y, double x) {
+	return atan2Kernel(y, x);
+}
+
+void sinCosBatch(std::span<const double> angles, std::span<SinCos> out) {
+	for (std::size_t i = 0; i < angles.size(); ++i)
+		out[i] = sinCosKernel(angles[i]);
+}
+
+void atan2Batch(std::span<const double> ys, std::span<const double> xs,
+					 std::span<double> out) {
+	for (std::size_t i = 0; i < ys.size(); ++i)
+		out[i] = atan2Kernel(ys[i], xs[i]);
+}
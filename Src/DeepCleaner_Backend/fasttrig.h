@@ -0,0 +1,34 @@
+/*-----------------------------------------------------------------------------
+File name : fasttrig.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the trigonometry of the robot moves. Built with
+DEEPCLEANER_FAST_TRIG, the functions are polynomial approximations without
+branches, computed the same way on every compiler and libm, and the batches
+over the robots are vectorized. Otherwise they call libm.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef FASTTRIG_H
+#define FASTTRIG_H
+
+#include <span>
+
+struct SinCos {
+	double sine = 0.0;
+	double cosine = 1.0;
+};
+
+// Within 1e-15 of libm for the angles of the robots, [-2pi, 2pi]
+SinCos fastSinCos(double angle);
+
+// Angle of (x, y) in ]-pi, pi], 0 for (0, 0). Within 1e-15 rad of libm
+double fastAtan2(double y, double x);
+
+// out[i] = fastSinCos(angles[i]), same values as one by one
+void sinCosBatch(std::span<const double> angles, std::span<SinCos> out);
+
+void atan2Batch(std::span<const double> ys, std::span<const double> xs,
+					 std::span<double> out);
+
+#endif // FASTTRIG_H
@@ -0,0 +1,95 @@
+/*-----------------------------------------------------------------------------
+File name : fileformat.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the file encodings
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <cctype>
+#include <iomanip>
+#include "fileformat.h"
+
+using json = nlohmann::json;
+
+const int JSON_INDENT = 4;
+const std::size_t HEADER_SIZE = 6;
+
+std::string formatName(FileFormat format) {
+	switch (format) {
+		case JSON_COMPACT: return "compact";
+		case CBOR: return "cbor";
+		case MSGPACK: return "msgpack";
+		case BSON: return "bson";
+		default: return "json";
+	}
+}
+
+bool parseFormatName(const std::string &name, FileFormat &format) {
+	for (FileFormat f: {JSON_PRETTY, JSON_COMPACT, CBOR, MSGPACK, BSON}) {
+		if (name == formatName(f)) {
+			format = f;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool isBinaryFormat(FileFormat format) {
+	return format == CBOR || format == MSGPACK || format == BSON;
+}
+
+void writeDocument(std::ostream &os, const json &document, FileFormat format) {
+	switch (format) {
+		case JSON_PRETTY:
+			os << std::setw(JSON_INDENT) << document;
+			break;
+		case JSON_COMPACT:
+			os << document;
+			break;
+		case CBOR:
+			json::to_cbor(document, os);
+			break;
+		case MSGPACK:
+			json::to_msgpack(document, os);
+			break;
+		case BSON:
+			json::to_bson(document, os);
+			break;
+	}
+}
+
+FileFormat detectFormat(std::istream &input) {
+	unsigned char header[HEADER_SIZE] = {};
+	std::istream::pos_type start = input.tellg();
+	input.read(reinterpret_cast<char *>(header), HEADER_SIZE);
+	std::streamsize count = input.gcount();
+	input.clear();
+	input.seekg(start);
+
+	if (count == 0)
+		return JSON_PRETTY;
+	unsigned char first = header[0];
+
+	// All the documents are objects at the root : CBOR map (major type 5)
+	if (first >= 0xA0 && first <= 0xBF)
+		return CBOR;
+	// MessagePack fixmap, map 16 or map 32
+	if ((first >= 0x80 && first <= 0x8F) || first == 0xDE || first == 0xDF)
+		return MSGPACK;
+	// BSON starts with the document size followed by the type of the first
+	// element and its name. Json text never has a control character there
+	if (count == HEADER_SIZE && header[4] >= 0x01 && header[4] <= 0x13 &&
+		 std::isalpha(header[5]))
+		return BSON;
+	return JSON_PRETTY;
+}
+
+json::input_format_t toInputFormat(FileFormat format) {
+	switch (format) {
+		case CBOR: return json::input_format_t::cbor;
+		case MSGPACK: return json::input_format_t::msgpack;
+		case BSON: return json::input_format_t::bson;
+		default: return json::input_format_t::json;
+	}
+}
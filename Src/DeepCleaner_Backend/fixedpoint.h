@@ -0,0 +1,76 @@
+/*-----------------------------------------------------------------------------
+File name : fixedpoint.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Fixed-point grid and integer frames of the exact simulation
+mode. The positions are kept on a grid of 1/FIXED_ONE pixel, the angles and
+the wheel speeds on grids of 1/FINE_ONE radian and pixel/sec, so a last bit
+difference of the math library does not reach the timeline, and the contacts
+are tested with integers. The time is a number of frames, the seconds are only
+computed from it.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <cmath>
+#include <cstdint>
+#include "position.h"
+
+using Fixed = std::int64_t;
+
+const double FIXED_ONE = 65536.0;      // 2^16 steps per pixel
+const double FINE_ONE = 4294967296.0;  // 2^32 steps per radian or pixel/sec
+
+// Rounded half away from zero, like llround without the library call
+inline Fixed toFixed(double value) {
+	double scaled = value * FIXED_ONE;
+	return Fixed(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+inline double fromFixed(Fixed value) { return double(value) / FIXED_ONE; }
+
+inline Position snapToGrid(const Position &p) {
+	return {fromFixed(toFixed(p.getX())), fromFixed(toFixed(p.getY()))};
+}
+
+// Angles and wheel speeds
+inline double snapFine(double value) {
+	return double(std::llround(value * FINE_ONE)) / FINE_ONE;
+}
+
+// Same as detectCollision for positions on the grid, without square root.
+// The differences of grid values are exact, far objects are rejected before
+// any product and the squares of the near ones stay small
+inline bool detectCollisionFixed(const Position &p1, double radius1,
+											const Position &p2, double radius2,
+											double epsilon) {
+	Fixed limit = toFixed(radius1 + radius2 + epsilon);
+	double reach = fromFixed(limit);
+	double dx = p1.getX() - p2.getX();
+	double dy = p1.getY() - p2.getY();
+	if ((std::abs(dx) > reach) | (std::abs(dy) > reach))
+		return false;
+	Fixed fx = Fixed(dx * FIXED_ONE), fy = Fixed(dy * FIXED_ONE);
+	return fx * fx + fy * fy <= limit * limit;
+}
+
+// Frame of a time in seconds, the nearest one
+inline std::int64_t timeToFrame(double time, int framePerSec) {
+	return std::llround(time * framePerSec);
+}
+
+inline double frameToTime(std::int64_t frame, int framePerSec) {
+	return double(frame) / framePerSec;
+}
+
+// First frame at which something due at time has happened, the first one
+// reaching time - tolerance like the float mode. The tolerance gives the frame
+// just before a time missing it by rounding
+inline std::int64_t firstFrameAfter(double time, int framePerSec,
+												double tolerance) {
+	return std::int64_t(std::ceil((time - tolerance) * framePerSec));
+}
+
+#endif // FIXEDPOINT_H
@@ -0,0 +1,265 @@
+/*-----------------------------------------------------------------------------
+File name : generator.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the scenario generator. The bodies are placed
+from the largest to the smallest at random places, a place being refused if
+it is too close to a body already placed. The placed bodies are kept in a
+grid of cells larger than two bodies, so a place is only compared with the
+bodies of the 9 cells around it and 100000 particles are placed in a moment.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "generator.h"
+
+// The engine is the same everywhere, the conversions to doubles are done here
+class RandomSource {
+
+public:
+	explicit RandomSource(std::uint64_t seed) : engine(seed) {}
+
+	// In [0, 1[
+	double unit() { return double(engine() >> 11) * 0x1.0p-53; }
+
+	double between(double low, double high) { return low + (high - low) * unit(); }
+
+	// Mean 0, deviation 1
+	double normal() {
+		double length = std::sqrt(-2 * std::log(1 - unit()));
+		return length * std::cos(2 * M_PI * unit());
+	}
+
+private:
+	std::mt19937_64 engine;
+};
+
+// Bodies placed so far, by cell of the world
+class PlacementGrid {
+
+public:
+	PlacementGrid(double minX, double minY, double width, double height,
+					  double cellSize, std::size_t bodies)
+		: minX(minX), minY(minY), cellSize(cellSize),
+		  columns(std::size_t(width / cellSize) + 1),
+		  rows(std::size_t(height / cellSize) + 1), heads(columns * rows, -1) {
+		next.reserve(bodies);
+		placed.reserve(bodies);
+	}
+
+	// No body closer than spacing, the bodies of the cells around are enough
+	// as a cell is larger than two bodies and the spacing
+	bool isFree(double x, double y, double radius, double spacing) const {
+		std::size_t column = columnOf(x), row = rowOf(y);
+		std::size_t lastColumn = std::min(column + 1, columns - 1);
+		std::size_t lastRow = std::min(row + 1, rows - 1);
+		for (std::size_t c = column ? column - 1 : 0; c <= lastColumn; ++c) {
+			for (std::size_t r = row ? row - 1 : 0; r <= lastRow; ++r) {
+				for (int body = heads[r * columns + c]; body != -1; body = next[body]) {
+					const Placed &other = placed[body];
+					double dx = x - other.x, dy = y - other.y;
+					double limit = radius + other.radius + spacing;
+					if (dx * dx + dy * dy < limit * limit)
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void add(double x, double y, double radius) {
+		std::size_t cell = rowOf(y) * columns + columnOf(x);
+		placed.push_back({x, y, radius});
+		next.push_back(heads[cell]);
+		heads[cell] = int(placed.size() - 1);
+	}
+
+private:
+	struct Placed {
+		double x, y, radius;
+	};
+
+	double minX, minY, cellSize;
+	std::size_t columns, rows;
+	std::vector<int> heads; // last body of every cell, -1 if empty
+	std::vector<int> next;  // previous body of the same cell
+	std::vector<Placed> placed;
+
+	std::size_t columnOf(double x) const {
+		return std::min(std::size_t((x - minX) / cellSize), columns - 1);
+	}
+
+	std::size_t rowOf(double y) const {
+		return std::min(std::size_t((y - minY) / cellSize), rows - 1);
+	}
+};
+
+static void checkParameters(const ScenarioParameters &p) {
+	std::string error;
+	if (p.robotCount < 0 || p.particleCount < 0)
+		error = "The numbers of robots and particles cannot be negative";
+	else if (p.robotRadius <= 0 || p.minRadius <= 0 || p.minRadius > p.maxRadius)
+		error = "The radii must be positive, the smallest one first";
+	else if (p.worldWidth < 0 || p.worldHeight < 0 || p.spacing < 0)
+		error = "The world size and the spacing cannot be negative";
+	else if (p.explosionDepth < 0 || p.explosionDepth > MAX_EXPLOSION_DEPTH)
+		error = "The explosion depth must be between 0 and " +
+				  std::to_string(MAX_EXPLOSION_DEPTH);
+	else if (p.firstExplosion < 0 || p.firstExplosion > p.lastExplosion ||
+				p.minChildDelay < 0 || p.minChildDelay > p.maxChildDelay)
+		error = "The explosion times and delays must be positive, the first first";
+	if (!error.empty())
+		throw std::invalid_argument(error);
+}
+
+static double drawRadius(const ScenarioParameters &p, RandomSource &random) {
+	switch (p.radiusDistribution) {
+		case NORMAL_RADIUS: {
+			double middle = (p.minRadius + p.maxRadius) / 2;
+			double deviation = (p.maxRadius - p.minRadius) / 6;
+			return std::clamp(middle + deviation * random.normal(), p.minRadius,
+									p.maxRadius);
+		}
+		case LOG_UNIFORM_RADIUS:
+			return std::exp(random.between(std::log(p.minRadius), std::log(p.maxRadius)));
+		default:
+			return random.between(p.minRadius, p.maxRadius);
+	}
+}
+
+static double drawExplosion(const ScenarioParameters &p, RandomSource &random) {
+	double range = p.lastExplosion - p.firstExplosion;
+	if (p.timeDistribution == UNIFORM_TIMES || range == 0)
+		return p.firstExplosion + range * random.unit();
+	// Exponential cut at the last explosion, a quarter of the range on average
+	// before the cut
+	double mean = range / 4;
+	double cut = 1 - std::exp(-range / mean);
+	return p.firstExplosion - mean * std::log(1 - cut * random.unit());
+}
+
+// One list per level of the tree, the children of the child i of a level are
+// at 4 * i to 4 * i + 3 of the next one
+static ExplosionTimes drawExplosionTree(const ScenarioParameters &p,
+													 RandomSource &random) {
+	ExplosionTimes times{{drawExplosion(p, random)}};
+	for (int level = 1; level <= p.explosionDepth; ++level) {
+		std::vector<double> children;
+		for (double parent: times.back()) {
+			for (int child = 0; child < EXPLOSION_CHILDREN; ++child)
+				children.push_back(parent + random.between(p.minChildDelay,
+																		  p.maxChildDelay));
+		}
+		times.push_back(std::move(children));
+	}
+	return times;
+}
+
+Scenario generateScenario(const ScenarioParameters &parameters) {
+	const ScenarioParameters &p = parameters;
+	checkParameters(p);
+	RandomSource random(p.seed);
+
+	// Robots after the particles, in the order of their ids
+	std::size_t bodies = std::size_t(p.particleCount) + std::size_t(p.robotCount);
+	std::vector<double> radii;
+	radii.reserve(bodies);
+	for (int i = 0; i < p.particleCount; ++i)
+		radii.push_back(drawRadius(p, random));
+	radii.insert(radii.end(), std::size_t(p.robotCount), p.robotRadius);
+
+	double covered = 0, largest = 0;
+	for (double radius: radii) {
+		covered += M_PI * (radius + p.spacing / 2) * (radius + p.spacing / 2);
+		largest = std::max(largest, radius);
+	}
+	double width = p.worldWidth > 0 ? p.worldWidth
+												: std::sqrt(covered / DEFAULT_WORLD_FILL);
+	double height = p.worldHeight > 0 ? p.worldHeight : width;
+	if (width < 2 * largest || height < 2 * largest)
+		throw std::runtime_error("The world is smaller than the largest body");
+	Position origin(-width / 2, -height / 2), end(width / 2, height / 2);
+
+	// Not more cells than bodies in a large world
+	double cellSize = std::max(2 * largest + p.spacing,
+										std::sqrt(width * height / double(bodies + 1)));
+	PlacementGrid grid(origin.getX(), origin.getY(), width, height, cellSize, bodies);
+	std::vector<std::size_t> order(bodies);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+		return radii[a] > radii[b];
+	});
+	std::vector<Position> positions(bodies);
+	for (std::size_t placedCount = 0; placedCount < bodies; ++placedCount) {
+		std::size_t body = order[placedCount];
+		double radius = radii[body];
+		bool placed = false;
+		for (int attempt = 0; attempt < PLACEMENT_TRIES && !placed; ++attempt) {
+			double x = random.between(origin.getX() + radius, end.getX() - radius);
+			double y = random.between(origin.getY() + radius, end.getY() - radius);
+			if (grid.isFree(x, y, radius, p.spacing)) {
+				grid.add(x, y, radius);
+				positions[body] = Position(x, y);
+				placed = true;
+			}
+		}
+		if (!placed)
+			throw std::runtime_error("The world is full, " +
+											 std::to_string(placedCount) + " of the " +
+											 std::to_string(bodies) + " bodies placed");
+	}
+
+	std::vector<Particle> particles;
+	particles.reserve(std::size_t(p.particleCount));
+	for (int i = 0; i < p.particleCount; ++i)
+		particles.emplace_back(i, positions[std::size_t(i)], radii[std::size_t(i)],
+									  drawExplosionTree(p, random));
+	std::vector<Robot> robots;
+	robots.reserve(std::size_t(p.robotCount));
+	for (int i = 0; i < p.robotCount; ++i) {
+		std::size_t body = std::size_t(p.particleCount + i);
+		robots.emplace_back(i, positions[body], p.robotRadius,
+								  random.between(0, 2 * M_PI), p.captureAngle * M_PI / 180,
+								  0.0, 0.0);
+	}
+	return {State(0.0, origin, end, robots, particles), p.constraints};
+}
+
+std::string radiusDistributionName(RadiusDistribution distribution) {
+	switch (distribution) {
+		case NORMAL_RADIUS: return "normal";
+		case LOG_UNIFORM_RADIUS: return "loguniform";
+		default: return "uniform";
+	}
+}
+
+bool parseRadiusDistribution(const std::string &name,
+									  RadiusDistribution &distribution) {
+	for (RadiusDistribution d: {UNIFORM_RADIUS, NORMAL_RADIUS, LOG_UNIFORM_RADIUS}) {
+		if (name == radiusDistributionName(d)) {
+			distribution = d;
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string timeDistributionName(TimeDistribution distribution) {
+	return distribution == EXPONENTIAL_TIMES ? "exponential" : "uniform";
+}
+
+bool parseTimeDistribution(const std::string &name, TimeDistribution &distribution) {
+	for (TimeDistribution d: {UNIFORM_TIMES, EXPONENTIAL_TIMES}) {
+		if (name == timeDistributionName(d)) {
+			distribution = d;
+			return true;
+		}
+	}
+	return false;
+}
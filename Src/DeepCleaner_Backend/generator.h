@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------------------
+File name : generator.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the scenario generator. A seed and the parameters give
+a base state, robots and particles placed without overlap, and its
+constraints. The numbers are drawn without the distributions of the standard
+library, which differ from one implementation to the other, so a seed gives
+the same scenario on every platform.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+#include "state.h"
+#include "timeline.h"
+
+typedef enum {
+	UNIFORM_RADIUS,    // between the smallest and the largest radius
+	NORMAL_RADIUS,     // around the middle, the range is six deviations
+	LOG_UNIFORM_RADIUS // as many particles between 5 and 10 as between 10 and 20
+} RadiusDistribution;
+
+typedef enum {
+	UNIFORM_TIMES,    // between the first and the last explosion
+	EXPONENTIAL_TIMES // most explosions soon after the first one
+} TimeDistribution;
+
+// Deepest explosion tree read by the simulation, the children of the children
+const int MAX_EXPLOSION_DEPTH = 2;
+// Particles created by an explosion
+const int EXPLOSION_CHILDREN = 4;
+// Part of the world covered by the bodies when its size is not given
+const double DEFAULT_WORLD_FILL = 0.1;
+// Random places tried for a body before the world is considered full
+const int PLACEMENT_TRIES = 1000;
+
+struct ScenarioParameters {
+	std::uint64_t seed = 1;
+	double worldWidth = 0.0;  // 0 to size the world from the bodies
+	double worldHeight = 0.0;
+	int robotCount = 10;
+	double robotRadius = 12.5;
+	double captureAngle = 12.5; // deg
+	int particleCount = 100;
+	RadiusDistribution radiusDistribution = UNIFORM_RADIUS;
+	double minRadius = 5.0;
+	double maxRadius = 50.0;
+	double spacing = 10.0; // smallest space between two bodies (pixels)
+	int explosionDepth = MAX_EXPLOSION_DEPTH;
+	TimeDistribution timeDistribution = UNIFORM_TIMES;
+	double firstExplosion = 5.0; // sec, explosions of the initial particles
+	double lastExplosion = 60.0;
+	double minChildDelay = 1.0;  // sec, explosion of a child after its parent
+	double maxChildDelay = 10.0;
+	Constraints constraints;
+};
+
+struct Scenario {
+	State state;
+	Constraints constraints;
+};
+
+// Throw std::invalid_argument for inconsistent parameters and
+// std::runtime_error if the bodies do not fit in the world
+Scenario generateScenario(const ScenarioParameters &parameters);
+
+std::string radiusDistributionName(RadiusDistribution distribution);
+
+// Return false if the name is not a known distribution
+bool parseRadiusDistribution(const std::string &name,
+									  RadiusDistribution &distribution);
+
+std::string timeDistributionName(TimeDistribution distribution);
+
+bool parseTimeDistribution(const std::string &name, TimeDistribution &distribution);
+
+#endif // GENERATOR_H
@@ -0,0 +1,99 @@
+/*-----------------------------------------------------------------------------
+File name : kinematics.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the kinematics of the robots. On an arc the
+center turns around a point at speed/omega from it. The arc through the
+target center tangent to the heading turns by twice the bearing of the target,
+its curvature is 2 sin(bearing) / distance.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <limits>
+#include "kinematics.h"
+#include "trajectory.h"
+
+// Angle of the target from the heading, in [-pi, pi]
+static double bearing(const Pose &pose, const Position &target) {
+	double direction = std::atan2(target.getY() - pose.position.getY(),
+											target.getX() - pose.position.getX());
+	return std::remainder(direction - pose.angle, 2 * M_PI);
+}
+
+Position arcPosition(const Position &start, double heading, double speed,
+							double omega, double t) {
+	if (speed == 0)
+		return start;
+	if (omega == 0)
+		return updateCoordinate(start, speed, heading, t);
+	double turnRadius = speed / omega;
+	double h = heading + omega * t;
+	return Position(start.getX() + turnRadius * (sin(h) - sin(heading)),
+						 start.getY() - turnRadius * (cos(h) - cos(heading)));
+}
+
+Pose advancePose(const Pose &pose, double radius, double leftSpeed,
+					  double rightSpeed, double deltaTime) {
+	if (deltaTime <= 0 || (leftSpeed == 0 && rightSpeed == 0))
+		return pose;
+	Pose moved = pose;
+	if (leftSpeed == rightSpeed) {
+		moved.position = updateCoordinate(pose.position, rightSpeed, pose.angle,
+													 deltaTime);
+		return moved;
+	}
+	double speed = (leftSpeed + rightSpeed) / 2;
+	double omega = angularSpeed(radius, leftSpeed, rightSpeed);
+	moved.position = arcPosition(pose.position, pose.angle, speed, omega,
+										  deltaTime);
+	moved.angle = updateAngle(pose.angle, radius, leftSpeed, rightSpeed, deltaTime);
+	return moved;
+}
+
+bool planArc(const Pose &pose, double radius, double captureAngle,
+				 const Position &target, double reach, const Constraints &constraints,
+				 ArcPlan &plan) {
+	double distance = linearDistance(pose.position, target);
+	double alpha = bearing(pose, target);
+	if (distance <= reach || std::abs(alpha) > MAX_ARC_BEARING)
+		return false;
+
+	// Signed, positive when the angle increases (left wheel faster)
+	double curvature = 2 * std::sin(alpha) / distance;
+	// At the contact the chord to the target center makes half its arc with
+	// the heading
+	if (std::asin(std::min(1.0, reach * std::abs(curvature) / 2)) > captureAngle)
+		return false;
+	double k = std::abs(curvature) * radius;
+	if (k == 0) {
+		plan.length = distance - reach;
+	} else {
+		// Turn left until the chord to the target center is reach
+		double turn = 2 * std::abs(alpha) -
+						  2 * std::asin(reach * std::abs(curvature) / 2);
+		plan.length = turn / std::abs(curvature);
+	}
+
+	// The outer wheel goes at (1 + k) times the center, the inner one at 1 - k
+	double speed = constraints.maxForwardSpeed / (1 + k);
+	if (k > 1)
+		speed = std::min(speed, constraints.maxBackwardSpeed / (k - 1));
+	plan.leftSpeed = speed * (1 + curvature * radius);
+	plan.rightSpeed = speed * (1 - curvature * radius);
+	plan.time = plan.length / speed;
+	return true;
+}
+
+double arcMiss(const Pose &pose, double radius, double leftSpeed,
+					double rightSpeed, const Position &target) {
+	double alpha = bearing(pose, target);
+	double speed = (leftSpeed + rightSpeed) / 2;
+	if (std::abs(alpha) > MAX_ARC_BEARING || speed <= 0)
+		return std::numeric_limits<double>::infinity();
+	double distance = linearDistance(pose.position, target);
+	double curvature = angularSpeed(radius, leftSpeed, rightSpeed) / speed;
+	double needed = 2 * std::sin(alpha) / distance;
+	// Sagitta of the difference of curvature over the distance
+	return std::abs(needed - curvature) * distance * distance / 2;
+}
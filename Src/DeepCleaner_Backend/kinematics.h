@@ -0,0 +1,63 @@
+/*-----------------------------------------------------------------------------
+File name : kinematics.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the kinematics of the differential drive robots. At
+constant wheel speeds a robot follows a line, turns on itself or follows an
+arc, and its pose is given in closed form for any duration. The arc planner
+finds the wheel speeds bringing a robot in contact with a target without
+stopping to turn first.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <cmath>
+#include "position.h"
+#include "timeline.h"
+
+// Largest angle between the heading and the target reached on an arc, a
+// target further aside is reached by turning on itself first
+const double MAX_ARC_BEARING = M_PI / 2;
+// Distance by which the arc followed may miss its target before a new one
+// is planned (pixels)
+const double ARC_MISS_TOLERANCE = 1.0;
+
+struct Pose {
+	Position position;
+	double angle = 0.0; // rad, [0, 2pi[
+};
+
+struct ArcPlan {
+	double leftSpeed = 0.0;
+	double rightSpeed = 0.0;
+	double length = 0.0; // distance covered by the center until the contact
+	double time = 0.0;   // sec at these speeds
+};
+
+// Center after t sec at the linear speed of the center and the angular speed
+// omega, starting at start with heading (rad). Not normalized, any omega
+Position arcPosition(const Position &start, double heading, double speed,
+							double omega, double t);
+
+// Pose after deltaTime at constant wheel speeds. Lines and rotations on itself
+// are computed as in the simulation step
+Pose advancePose(const Pose &pose, double radius, double leftSpeed,
+					  double rightSpeed, double deltaTime);
+
+// Arc from the pose through the center of the target, ending when the
+// distance to it is reach (sum of the radii). The speed of the center is the
+// largest one keeping both wheels in the constraints. False if the target is
+// further than MAX_ARC_BEARING aside, already within reach, or would be met
+// out of the capture angle (rad)
+bool planArc(const Pose &pose, double radius, double captureAngle,
+				 const Position &target, double reach, const Constraints &constraints,
+				 ArcPlan &plan);
+
+// Approximate distance by which the arc followed at these wheel speeds misses
+// the target, infinite if the target is further than MAX_ARC_BEARING aside
+double arcMiss(const Pose &pose, double radius, double leftSpeed,
+					double rightSpeed, const Position &target);
+
+#endif // KINEMATICS_H
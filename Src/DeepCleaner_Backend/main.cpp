@@ -5,237 +5,197 @@ Creation date : 29.08.2022
 Description :  Program that handles the timeline generation based on a base state
  and constraints
 
-Command line arguments: DeepCleaner_Backend [-help] [-b <Base state path>]
- [-c <Constraints path>] [-o <Output path>]
+Command line arguments: DeepCleaner_Backend [-h|--help] [-b|--base <Base state>]
+ [-c|--constraints <Constraints>] [-o|--output <Output>] [-f|--format <Format>]
+ [-z|--codec <Compression codec>] [-k|--checkpoint <Checkpoint>]
+ [-K|--checkpoint-period <Seconds>] [-r|--resume <Checkpoint to resume>]
+ [-t|--fork <Timeline to fork>]
+ [-a|--fork-time <Fork time>] [-i|--fork-index <Fork state index>]
+ [-s|--step <Step mode>] [-j|--threads <Threads>] [-m|--compact <Tolerance>]
+ [-p|--fps <Frames per second>] [-x|--time <Time mode>] [-v|--moves <Robot moves>]
+ [-g|--targets <Targets>] [-q|--quiet] [-S|--stats] [-I|--interactive]
+A value is given as -x <value>, --name <value> or --name=<value>. The paths are
+ used as given, with the extension added if the file name has none, and the
+ path - reads the standard input or writes the standard output. The menu is
+ only shown with --interactive.
+Exit code: 0 if the timeline is written, 1 on error
 Compiler : Mingw-w64 g++ 11.2.0
 -----------------------------------------------------------------------------*/
 
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
-#include <cmath>
 #include "utils.h"
 #include "timeline.h"
-#include "position.h"
 #include "state.h"
-#include "robot.h"
-#include "particle.h"
-#include "trajectory.h"
+#include "simulation.h"
+#include "taskpool.h"
 #include <exception>
-#include <set>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
 using namespace std;
-const double SQRT2 = sqrt(2.0);
 const string CONSTRAINT_EXT = ".constraints", STATE_EXT = ".stat",
-        TIMELINE_EXT = ".tlin";
-const char BASE_STATE_ARG = 'b', CONSTRAINTS_ARG = 'c', OUTPUT_PATH_ARG = 'o';
-const string HELP1 = "-help", HELP2 = "-?", HELP3 = "-h";
-const double EPSILON = 2.0;
-const string DEFAULT_PATH = R"(..\..\JSON\)";
-const int FRAME_PER_SEC = 24;
-const double TIME_PER_FRAME = 1.0 / FRAME_PER_SEC;
-
-typedef enum {
-    IDLE, ROTATION, LINE
-} MovementType;
-
-struct Movement {
-    Robot *robot;
-    MovementType movementType;
-    double lSpeed;
-    double rSpeed;
+        TIMELINE_EXT = ".tlin", CHECKPOINT_EXT = ".chkp";
+const char BASE_STATE_ARG = 'b', CONSTRAINTS_ARG = 'c', OUTPUT_PATH_ARG = 'o',
+        FORMAT_ARG = 'f', CODEC_ARG = 'z', CHECKPOINT_ARG = 'k',
+        CHECKPOINT_PERIOD_ARG = 'K', RESUME_ARG = 'r',
+        FORK_ARG = 't', FORK_TIME_ARG = 'a', FORK_INDEX_ARG = 'i',
+        STEP_MODE_ARG = 's', THREADS_ARG = 'j', COMPACT_ARG = 'm',
+        FRAME_RATE_ARG = 'p', TIME_MODE_ARG = 'x', MOVE_MODE_ARG = 'v',
+        TARGET_ARG = 'g', QUIET_ARG = 'q', STATS_ARG = 'S', INTERACTIVE_ARG = 'I',
+        HELP_ARG = 'h';
+const string HELP1 = "-help", HELP2 = "-?";
+// Path of the standard input or output
+const string STANDARD_STREAM = "-";
+const double CHECKPOINT_PERIOD = 30.0; // sec, by default
+
+struct OptionName {
+    char letter;
+    string name; // after --
+    bool hasValue;
 };
 
-map<int, Movement> initRobots(vector<Robot> &robots, MovementType status);
+const vector<OptionName> OPTION_NAMES = {
+        {BASE_STATE_ARG,  "base",        true},
+        {CONSTRAINTS_ARG, "constraints", true},
+        {OUTPUT_PATH_ARG, "output",      true},
+        {FORMAT_ARG,      "format",      true},
+        {CODEC_ARG,       "codec",       true},
+        {CHECKPOINT_ARG,  "checkpoint",  true},
+        {CHECKPOINT_PERIOD_ARG, "checkpoint-period", true},
+        {RESUME_ARG,      "resume",      true},
+        {FORK_ARG,        "fork",        true},
+        {FORK_TIME_ARG,   "fork-time",   true},
+        {FORK_INDEX_ARG,  "fork-index",  true},
+        {STEP_MODE_ARG,   "step",        true},
+        {THREADS_ARG,     "threads",     true},
+        {COMPACT_ARG,     "compact",     true},
+        {FRAME_RATE_ARG,  "fps",         true},
+        {TIME_MODE_ARG,   "time",        true},
+        {MOVE_MODE_ARG,   "moves",       true},
+        {TARGET_ARG,      "targets",     true},
+        {QUIET_ARG,       "quiet",       false},
+        {STATS_ARG,       "stats",       false},
+        {INTERACTIVE_ARG, "interactive", false},
+        {HELP_ARG,        "help",        false}};
+
+struct Options {
+    string baseState = "stateOriginExemple" + STATE_EXT;
+    string constraints = "constraints" + CONSTRAINT_EXT;
+    string output = "generatedTimeline" + TIMELINE_EXT;
+    FileFormat format = JSON_PRETTY;
+    bool compressed = false;
+    BlockCodec codec = NO_CODEC;
+    string checkpoint; // no checkpoint if empty
+    double checkpointPeriod = CHECKPOINT_PERIOD; // sec between two checkpoints
+    string resume;     // checkpoint to resume from, if not empty
+    bool baseStateGiven = false;
+    string fork;       // timeline to simulate again from one of its states
+    double forkTime = -1.0;
+    long forkIndex = -1;
+    bool stepModeGiven = false;
+    StepMode stepMode = LEGACY_STEP;
+    bool moveModeGiven = false;
+    MoveMode moveMode = TURN_AND_GO;
+    bool targetModeGiven = false;
+    TargetMode targetMode = NEAREST_TARGET;
+    unsigned threads = 0; // number of cores if 0
+    double compactTolerance = -1.0; // timeline not compacted if negative
+    int framePerSec = DefaultSimConfig::framePerSec;
+    bool exact = false; // integer frames and fixed-point positions
+    bool quiet = false; // no progress messages
+    bool stats = false; // statistics of the run at the end
+    bool interactive = false;
+    bool help = false;
+};
 
-void assignAllNearestParticle(vector<Robot> &robots, vector<Particle> &particles);
+void showMenuHelp();
 
-void assignNearestParticle(Robot &robot, vector<Particle> &particles);
+void showHelp(ostream &os);
 
-Movement initRotation(Robot &r, Position pPos, Constraints con);
+string argumentList();
 
-Movement initLineMovement(Robot &r, Position pPos, Constraints con, double pRadius);
+// Throw std::invalid_argument for an unknown option or a wrong value
+void manageArguments(int argc, char *argv[], Options &options);
 
-Movement initIdleMovement(Robot &r);
+void applyOption(char letter, const string &value, Options &options);
 
-bool hasExploded(Particle &p, double currentTime);
+double parseNumber(const string &value);
 
-void showMenuHelp();
+// Same, the names of the values in the errors
+double parseNonNegative(const string &value, const string &name);
 
-void showArgHelp();
+long parseInteger(const string &value, long minimum, const string &name);
 
-string argumentList();
+void menuSelection(Options &options);
 
-bool manageArguments(int argc, char *argv[], string &bst, string &cst, string &tln);
+// Progress messages, on the error output when the timeline is written on the
+// standard output
+ostream &progress(const Options &options);
 
-void menuSelection(string &bst, string &cst, string &out);
+void setBinaryMode(FILE *stream);
 
-void manageParticleExplosion(double timer, bool &explosionHappened,
-                             vector<Particle> &particles);
+State loadState(const string &path);
 
-Particle *particleCollision(Robot r1, vector<Particle> &particles);
+Constraints loadConstraints(const string &path);
 
-bool robotCollision(Robot r1, vector<Robot> &robs);
+Timeline loadTimeline(const string &path);
 
-Particle *findTargetParticle(Robot r, vector<Particle> &particles);
+template <SimConfig Config>
+void runSimulation(const Options &options, const Config &config);
+
+template <SimConfig Config>
+void forkTimeline(const Options &options, const Constraints &constraints,
+                  const Config &config, Timeline &newTimeline);
+
+void writeTimeline(Timeline &timeline, const Options &options,
+                   chrono::steady_clock::time_point start);
 
 
 int main(int argc, char *argv[]) {
-    string outputFname = DEFAULT_PATH + "generatedTimeline" + TIMELINE_EXT,
-            baseStateFname = DEFAULT_PATH + "stateOriginExemple" + STATE_EXT,
-            constraintsFname = DEFAULT_PATH + "constraints" + CONSTRAINT_EXT;
-    if (!manageArguments(argc, argv, baseStateFname, constraintsFname,
-                         outputFname)) {
-        menuSelection(baseStateFname, constraintsFname, outputFname);
+    Options options;
+    try {
+        manageArguments(argc, argv, options);
+    }
+    catch (invalid_argument &e) {
+        cerr << e.what() << "\nSee DeepCleaner_Backend --help\n";
+        return EXIT_FAILURE;
+    }
+    if (options.help) {
+        showHelp(cout);
+        return EXIT_SUCCESS;
     }
+    if (argc <= 1) {
+        showHelp(cerr);
+        return EXIT_FAILURE;
+    }
+    if (options.interactive) {
+        printTitle();
+        menuSelection(options);
+    }
+    TaskPool::setSharedThreadCount(options.threads);
     try {
-        //Create a timeline with base state
-        Timeline newTimeline;
-        newTimeline.deserializeConstraints(constraintsFname);
-        Constraints constraints = newTimeline.getConstraints();
-        newTimeline.addAndSetState(State(baseStateFname));
-
-        State *initialState = newTimeline.getCurrentState();
-        vector<Robot> robots = initialState->getRobots();
-        vector<Particle> particles = initialState->getParticles();
-
-        Position wo(initialState->getWorldOrigin());
-        Position we(initialState->getWorldEnd());
-
-        map<int, Movement> movementMap = initRobots(robots, IDLE);
-
-        assignAllNearestParticle(robots, particles);
-
-        // robot id->movement
-        double timer = 0;
-        double targetAngle;
-
-        bool particleExploded;
-        bool commandSent;
-        bool particleEaten;
-        bool hasCollided;
-
-        bool hasCollidedWithParticle;
-        bool hasCollidedWithRobot;
-
-        while (!newTimeline.getCurrentState()->getParticles().empty()) {
-            // Flags for state creation
-            particleExploded = false;
-            commandSent = false;
-            particleEaten = false;
-            hasCollided = false;
-            //For each particle Manage check if it will explode
-            manageParticleExplosion(timer, particleExploded, particles);
-            if (particleExploded)
-                assignAllNearestParticle(robots, particles);
-
-            for (Robot &r: robots) {
-                hasCollidedWithParticle = false;
-                hasCollidedWithRobot = false;
-                //Find the particle linked to the current robot
-                Particle *p = findTargetParticle(r, particles);
-
-                //Get the actual movement status of the robot
-                Movement movement = {movementMap[r.getId()]};
-
-
-                //Special condition for collision management.
-                if (movement.movementType != IDLE) {
-                    //Store object that collides with our robot
-                    bool robotCollider = robotCollision(r, robots);
-                    Particle *particleCollider = particleCollision(r, particles);
-
-                    if (robotCollider || particleCollider != nullptr) {
-                        movementMap[r.getId()] = initIdleMovement(r);
-                        r.setSpeed(movement.lSpeed, movement.rSpeed);
-                        hasCollided = true;
-                    }
-                    if (robotCollider) {
-							  //se stop
-                        hasCollidedWithRobot = true;
-								movementMap[r.getId()] = initIdleMovement(r);
-								r.setSpeed(movement.lSpeed,movement.rSpeed);
-                        
-                    }
-                    if (particleCollider != nullptr) {
-                        particles.erase(remove_if(particles.begin(), particles.end(),
-                                                  [=](const Particle &p) {
-                                                      return p.getId() ==
-                                                             particleCollider->getId();
-                                                  }));
-                        particleEaten = true;
-                        hasCollidedWithParticle = true;
-                        r.setScore(r.getScore() + getArea(p->getRadius()));
-                    }
-                }
-                movement = {movementMap[r.getId()]};
-                if (movement.movementType == IDLE) {
-
-                    //If the robot collided with particle or if it hasn't collided at all
-                    // starting point of our moving algorithm
-                    if (hasCollidedWithParticle || (!hasCollidedWithParticle &&
-                                                    !hasCollidedWithRobot)) {
-                        assignAllNearestParticle(robots, particles);
-                        p = findTargetParticle(r, particles);
-
-
-                        targetAngle = getAngle(r.getPosition(), p->getPosition());
-                        if (!equal(targetAngle, r.getAngle(), 0.005)) {
-
-                            //Set the new movement the robot is doing
-                            movement = initRotation(r, p->getPosition(),
-                                                    constraints);
-                            movementMap[r.getId()] = {movement};
-                            r.setSpeed(movement.lSpeed, movement.rSpeed);
-                        } else {
-                            // Rotation is finished, now go in straight line to the particle
-                            movement = initLineMovement(r, p->getPosition(),
-                                                        constraints, p->getRadius());
-                            r.setSpeed(movement.lSpeed, movement.rSpeed);
-                            movementMap[r.getId()] = {movement};
-                        }
-                        commandSent = true;
-                    }
-
-                } else if (movement.movementType == ROTATION) {
-                    if (particleEaten || particleExploded) {
-                        assignAllNearestParticle(robots, particles);
-                        p = findTargetParticle(r, particles);
-                    }
-                    targetAngle = getAngle(r.getPosition(), p->getPosition());
-                    if (!equal(targetAngle, r.getAngle(), 0.005)) {
-                        double newAngle = updateAngle(r.getAngle(), r.getRadius(), r
-                                .getLeftSpeed(), r.getRightSpeed(), TIME_PER_FRAME);
-                        r.setAngle(toDeg(newAngle));
-                    } else {
-                        movement = initLineMovement(r, p->getPosition(),
-                                                    constraints, p->getRadius());
-                        r.setSpeed(movement.lSpeed, movement.rSpeed);
-                        movementMap[r.getId()] = {movement};
-                        commandSent = true;
-                    }
-                } else if (movement.movementType == LINE) {
-                    if (particleEaten || particleExploded) {
-                        assignAllNearestParticle(robots, particles);
-                        p = findTargetParticle(r, particles);
-                    }
-                    Position newPos = updateCoordinate(r.getPosition(),
-                                                       r.getRightSpeed(),
-                                                       r.getAngle(RAD),
-                                                       TIME_PER_FRAME);
-                    r.setPosition(newPos);
-                }
-
-            }
-            if (particleExploded || commandSent || particleEaten || hasCollided) {
-                newTimeline.addAndSetState(State(timer, wo, we, robots, particles));
-            }
-            timer += TIME_PER_FRAME;
-        }
-        newTimeline.serialize(outputFname);
-        cout << "Timeline successfully generated at : " << outputFname << '\n';
-        //pause("Press enter to quit...");
+        // The constants of the default configurations are folded in the
+        // engine, another frame rate goes through the runtime one
+        if (options.framePerSec != DefaultSimConfig::framePerSec)
+            runSimulation(options, RuntimeSimConfig(options.framePerSec,
+                                                    options.exact));
+        else if (options.exact)
+            runSimulation(options, ExactSimConfig());
+        else
+            runSimulation(options, DefaultSimConfig());
     }
     catch (exception &e) {
         cerr << "Exception occurred : " << e.what() << '\n';
@@ -244,239 +204,227 @@ int main(int argc, char *argv[]) {
     return EXIT_SUCCESS;
 }
 
-Movement initRotation(Robot &r, Position pPos, Constraints con) {
-    // Calculate the angle that we need to rotate with deltaX and deltaY
-    double targetAngle = getAngle(r.getPosition(), pPos);
-
-    // Calculate the difference between the 2 angles
-    double effectiveAngle = deltaAngle(r.getAngle(RAD), targetAngle);
-
-    //Manage the direction of rotation to rotate the minimum distance
-    AngularDirection dir = rotateShortestPath(r.getAngle(RAD), targetAngle);
-
-    //Calculate the rotation time with maximum speed (left & right must be equal)
-    double maxRotationSpeed = min(con.maxBackwardSpeed, con.maxForwardSpeed);
-
-    //Inverse rotationSpeed if CCW
-    if (dir == CCW)
-        maxRotationSpeed = -maxRotationSpeed;
-
-    // Get the angular speed in rad/s
-    double omega = angularSpeed(r.getRadius(), maxRotationSpeed, -maxRotationSpeed);
-
-    // Now get the time that the rotation takes
-    double time = rotationTime(effectiveAngle, omega);
-
-    //Avoid precision problems
-    double syncedTime = getSyncTime(time, con.commandTimeInterval);
-
-    // Calculate the new speed synced to the time contraints
-    if (dir == CW)
-        omega = effectiveAngle / syncedTime;
-    else
-        omega = -effectiveAngle / syncedTime;
-
-    double syncedSpeed = (omega * 2 * r.getRadius()) / 2;
-
-    Movement rotMovement = {&r, ROTATION, syncedSpeed,
-                            -syncedSpeed};
-    return rotMovement;
-}
-
-Movement initLineMovement(Robot &r, Position pPos, Constraints con, double pRadius) {
-    //TODO ALIGNEMENT AVEC TIMER
-    double distance =
-            linearDistance(r.getPosition(), pPos) - r.getRadius() - pRadius;
-    double time = distance / con.maxForwardSpeed;
-    double syncedTime = getSyncTime(time, con.commandTimeInterval);
-    double syncedSpeed = distance / syncedTime;
-    Movement linearMovement = {&r, LINE, syncedSpeed, syncedSpeed};
-    return linearMovement;
-}
-
-
-
-Movement initIdleMovement(Robot &r) {
-    return Movement{&r, IDLE, 0, 0};
-}
+template <SimConfig Config>
+void runSimulation(const Options &options, const Config &config) {
+    auto start = chrono::steady_clock::now();
+    if (!options.fork.empty()) {
+        Constraints constraints = loadConstraints(options.constraints);
+        Timeline newTimeline;
+        forkTimeline(options, constraints, config, newTimeline);
+        writeTimeline(newTimeline, options, start);
+        return;
+    }
 
-bool allRobotsStopped(map<int, Movement> &movementMap) {
-    for (auto &[id, movement]: movementMap) {
-        if (movement.movementType != IDLE) {
-            return false;
+    unique_ptr<BasicSimulation<Config>> simulation;
+    if (options.resume.empty()) {
+        //Create a timeline with base state
+        Constraints constraints = loadConstraints(options.constraints);
+        simulation = make_unique<BasicSimulation<Config>>(
+                loadState(options.baseState), constraints, BASE_STATE, config);
+    } else {
+        simulation = make_unique<BasicSimulation<Config>>(options.resume, config);
+        progress(options) << "Resumed at " << simulation->getTime() << " sec\n";
+    }
+    if (options.stepModeGiven)
+        simulation->setStepMode(options.stepMode);
+    if (options.moveModeGiven)
+        simulation->setMoveMode(options.moveMode);
+    if (options.targetModeGiven)
+        simulation->setTargetMode(options.targetMode);
+    // Every state of the journal can then be forked without simulating the
+    // states before it
+    if (!options.checkpoint.empty())
+        simulation->setRecordEngine(true);
+
+    auto lastCheckpoint = chrono::steady_clock::now();
+    while (!simulation->isFinished()) {
+        simulation->step();
+        if (!options.checkpoint.empty() &&
+            chrono::duration<double>(chrono::steady_clock::now() - lastCheckpoint)
+                    .count() >= options.checkpointPeriod) {
+            simulation->saveCheckpoint(options.checkpoint);
+            lastCheckpoint = chrono::steady_clock::now();
         }
     }
-    return true;
+    // The last checkpoint holds the whole run
+    if (!options.checkpoint.empty())
+        simulation->saveCheckpoint(options.checkpoint);
+
+    writeTimeline(simulation->getTimeline(), options, start);
 }
 
-bool hasExploded(Particle &p, double currentTime) {
-    ExplosionTimes times = *p.getExplosionTime();
-    if (times.at(0).at(0) < currentTime || equal(times.at(0).at(0), currentTime,
-                                                 0.0001)) {
-        return true;
+template <SimConfig Config>
+void forkTimeline(const Options &options, const Constraints &constraints,
+                  const Config &config, Timeline &newTimeline) {
+    // A checkpoint has the engine data of its states, a timeline only the bodies
+    bool fromCheckpoint = options.fork.ends_with(CHECKPOINT_EXT);
+    Timeline source = fromCheckpoint ? loadCheckpointStates(options.fork)
+                                     : loadTimeline(options.fork);
+    span<const State> states = source.getStates();
+    if (states.empty())
+        throw runtime_error("The timeline to fork is empty");
+
+    // The edited state given with -b replaces the state it was saved from
+    State startState;
+    if (options.baseStateGiven)
+        startState = loadState(options.baseState);
+    size_t index;
+    if (options.forkIndex >= 0)
+        index = size_t(options.forkIndex);
+    else if (options.forkTime >= 0.0)
+        index = source.getStateIndex(options.forkTime);
+    else if (options.baseStateGiven)
+        index = source.getStateIndex(startState.getTime());
+    else
+        throw runtime_error("Give the fork time, the state index or the edited state");
+    if (index >= states.size())
+        throw runtime_error("The fork state index is out of the timeline");
+    if (!options.baseStateGiven)
+        startState = states[index];
+
+    // The prefix is kept verbatim, only the suffix is simulated. The run of a
+    // timeline is simulated again up to the fork, for its targets and routes
+    for (size_t i = 0; i < index; ++i)
+        newTimeline.addState(states[i]);
+    newTimeline.addState(startState);
+    const State *editedState = options.baseStateGiven ? &startState : nullptr;
+    if (fromCheckpoint) {
+        for (const State &state: simulateFrom(options.fork, index, editedState, config))
+            newTimeline.addState(state);
+        progress(options) << "Forked at state " << index << " (" << startState.getTime()
+                          << " sec) of the checkpoint\n";
+        return;
+    }
+    optional<vector<State>> suffix = simulateFrom(
+            states, index, editedState, constraints, config, options.stepMode,
+            options.moveMode, options.targetMode);
+    if (!suffix) {
+        progress(options) << "The timeline was not simulated with these options, "
+                             "the targets are chosen again from the fork state\n";
+        suffix = simulateFrom(startState, constraints, config, options.stepMode,
+                              options.moveMode, options.targetMode);
     }
-    return false;
+    for (const State &state: *suffix)
+        newTimeline.addState(state);
+    progress(options) << "Forked at state " << index << " (" << startState.getTime()
+                      << " sec)\n";
 }
 
-bool robotCollision(Robot r1, vector<Robot> &robs) {
-    for (Robot &robot: robs) {
-        if (r1.getId() != robot.getId() &&
-            detectCollision(r1.getPosition(), r1.getRadius(), robot.getPosition(),
-                            robot.getRadius(), EPSILON)) {
-            return true;
+void writeTimeline(Timeline &timeline, const Options &options,
+                   chrono::steady_clock::time_point start) {
+    auto computed = chrono::steady_clock::now();
+    size_t removed = 0;
+    if (options.compactTolerance >= 0.0) {
+        removed = timeline.compact(options.compactTolerance);
+        progress(options) << "Compaction removed " << removed << " states\n";
+    }
+    if (options.output != STANDARD_STREAM) {
+        if (options.compressed)
+            timeline.serializeBlocks(options.output, options.codec);
+        else
+            timeline.serialize(options.output, options.format);
+        progress(options) << "Timeline successfully generated at : "
+                          << options.output << '\n';
+    } else {
+        setBinaryMode(stdout);
+        if (options.compressed) {
+            // The index of the blocks is written back, cout cannot seek
+            stringstream blocks(ios::in | ios::out | ios::binary);
+            timeline.serializeBlocks(blocks, options.codec);
+            cout << blocks.rdbuf();
+        } else {
+            timeline.serialize(cout, options.format);
         }
+        cout.flush();
+        if (!cout)
+            throw runtime_error("Error writing the timeline on the standard output");
     }
-    return false;
-}
 
-Particle *particleCollision(Robot r1, vector<Particle> &particles) {
-    for (Particle &p: particles) {
-        if (detectCollision(r1.getPosition(), r1.getRadius(), p.getPosition(),
-                            p.getRadius(), EPSILON)) {
-            return &p;
+    if (options.stats) {
+        chrono::duration<double> computing = computed - start;
+        chrono::duration<double> writing = chrono::steady_clock::now() - computed;
+        span<const State> states = timeline.getStates();
+        // Beside the timeline, even in quiet mode
+        ostream &os = options.output == STANDARD_STREAM ? cerr : cout;
+        os << "States : " << states.size();
+        if (options.compactTolerance >= 0.0)
+            os << " (" << removed << " removed by the compaction)";
+        os << '\n';
+        if (!states.empty()) {
+            const State &last = states.back();
+            double score = 0.0;
+            for (const Robot &robot: last.getRobots())
+                score += robot.getScore();
+            os << "Simulated time : " << last.getTime() << " sec\n"
+               << "Robots : " << last.getRobots().size() << ", total score : "
+               << score << '\n'
+               << "Particles left : " << last.getParticles().size() << '\n';
         }
+        os << "Computed in " << computing.count() << " sec, written in "
+           << writing.count() << " sec\n";
     }
-    return nullptr;
 }
 
-map<int, Movement> initRobots(vector<Robot> &robots, MovementType status) {
-    map<int, Movement> movementMap;
-    for (Robot &rob: robots) {
-        // Set the robots to idle
-        movementMap[rob.getId()] = {&rob, status, 0, 0};
-    }
-    return movementMap;
+ostream &progress(const Options &options) {
+    static ostream discarded(nullptr);
+    if (options.quiet)
+        return discarded;
+    return options.output == STANDARD_STREAM ? cerr : cout;
 }
 
-void assignAllNearestParticle(vector<Robot> &robots, vector<Particle> &particles) {
-    //The robots select the nearest particle automatically
-    if(particles.size() < 1)
-        return;
-    for (Robot &rob: robots) {
-        assignNearestParticle(rob, particles);
-        //if assigned particle == other robots assigned particle, then change it
-        Robot samePartRob =  *(find_if(robots.begin(), robots.end(),[=](Robot r)
-        {
-            if(r.getTargetParticleId()!= -1 && r.getId() != rob.getId()) {
-                return r.getTargetParticleId() == rob.getTargetParticleId();
-            }
-            return false;
-        }));
-
-        if(rob.getTargetParticleId() != -1 &&
-        rob.getTargetParticleId() == samePartRob.getTargetParticleId()){
-
-            vector<Particle> copyPart(particles);
-            copyPart.erase(remove_if(copyPart.begin(), copyPart.end(),
-                                      [=](const Particle &p) {
-                                          return rob.getTargetParticleId() == p.getId();
-                                      }));
-
-            assignNearestParticle(rob, copyPart);
-        }
-    }
+void setBinaryMode(FILE *stream) {
+    // The binary formats must not have their line ends translated
+#ifdef _WIN32
+    _setmode(_fileno(stream), _O_BINARY);
+#else
+    (void) stream;
+#endif
 }
 
-void assignNearestParticle(Robot &robot, vector<Particle> &particles) {
-    int nearestParticleId = -1;
-    double dist = numeric_limits<double>::max();
-    for (Particle &p: particles) {
-        double newDist = linearDistance(robot.getPosition(), p.getPosition());
-        if (newDist <= dist) {
-            nearestParticleId = p.getId();
-            dist = newDist;
-        }
-    }
-    robot.setTargetParticleId(nearestParticleId);
+// The readers seek back after looking at the format, a pipe cannot
+static stringstream readStandardInput() {
+    setBinaryMode(stdin);
+    stringstream input(ios::in | ios::out | ios::binary);
+    input << cin.rdbuf();
+    return input;
 }
 
-void manageParticleExplosion(double timer, bool &explosionHappened,
-                             vector<Particle> &particles) {
-    vector<Particle> copyParticles(particles);
-    int maxId = std::max_element(copyParticles.begin(), copyParticles.end(),
-                                 [](Particle &p1, Particle &p2) {
-                                     return p1.getId()
-                                            < p2.getId();
-                                 })->getId();
-    for (Particle &particle: copyParticles) {
-        try {
-            if (hasExploded(particle, timer)) {
-                int id = particle.getId();
-                ExplosionTimes currentExplosionTime = *particle.getExplosionTime();
-                if (currentExplosionTime.size() > 1) {
-                    double radius = ((particle.getRadius() * 2) / (1 + SQRT2)) / 2;
-                    Position newPos[] = {
-                            Position(particle.getPosition().getX() - radius,
-                                     particle.getPosition().getY() - radius),
-                            Position(particle.getPosition().getX() - radius,
-                                     particle.getPosition().getY() + radius),
-                            Position(particle.getPosition().getX() + radius,
-                                     particle.getPosition().getY() - radius),
-                            Position(particle.getPosition().getX() + radius,
-                                     particle.getPosition().getY() + radius)};
-                    unsigned index = 0;
-                    ExplosionTimes newExplosionTimes;
-                    for (double &childTime: currentExplosionTime.at(1)) {
-                        maxId++;
-                        newExplosionTimes.push_back({childTime});
-                        if (currentExplosionTime.size() > 2) {
-
-                                //Push back each child vector
-                       newExplosionTimes.push_back(
-                               {currentExplosionTime.at(2).at(index * 4u),
-                                currentExplosionTime.at(2).at(index * 4 + 1u),
-                                currentExplosionTime.at(2).at(index * 4 + 2u),
-                                currentExplosionTime.at(2).at(index * 4 + 3u)});
-
-                        }
-                        //Create 4 new particles
-                        particles.emplace_back(maxId, newPos[index], radius,
-                                               newExplosionTimes);
-                        newExplosionTimes.clear();
-                        index++;
-                    }
-                }
-                explosionHappened = true;
-                //Erase the exploded particle
-                particles.erase(remove_if(particles.begin(), particles.end(),
-                                          [=](const Particle &p) {
-                                              return p.getId() == id;
-                                          }));
-            }
-        }
-        catch (exception &e) {
-            cerr << "Id : " << particle.getId()
-            << " Explosion time : " << (*particle.getExplosionTime())[0][0]
-            << " Timer : " << timer << endl
-            << "What " << e.what() << endl;
-            throw(e);
-        }
-    }
+State loadState(const string &path) {
+    if (path != STANDARD_STREAM)
+        return State(path);
+    stringstream input = readStandardInput();
+    State state;
+    state.deserialize(input);
+    return state;
 }
 
+Constraints loadConstraints(const string &path) {
+    if (path != STANDARD_STREAM)
+        return Timeline().deserializeConstraints(path);
+    stringstream input = readStandardInput();
+    return Timeline().deserializeConstraints(input);
+}
 
-Particle *findTargetParticle(Robot r, vector<Particle> &particles) {
-    Particle *p = &(*find_if(particles.begin(),
-                             particles.end(), [=](const Particle &p) {
-                return p.getId() == r.getTargetParticleId();
-            }));
-    return p;
+Timeline loadTimeline(const string &path) {
+    if (path != STANDARD_STREAM)
+        return Timeline(path);
+    stringstream input = readStandardInput();
+    Timeline timeline;
+    timeline.deserialize(input);
+    return timeline;
 }
 
-void menuSelection(string &bst, string &cst, string &out) {
+void menuSelection(Options &options) {
     int menuSelection = 0;
     do {
-        string currentBst = bst.substr(bst.find_last_of('\\') + 1);
-        string currentCst = cst.substr(bst.find_last_of('\\') + 1);
-        string currentOut = out.substr(bst.find_last_of('\\') + 1);
         menuSelection = 0;
         std::cout << "Please enter the desired operation : \n\n"
                   << "1) Load the base state & generate the Timeline\n"
-                  << "2) Set the output timeline name (current = " << currentOut
+                  << "2) Set the output timeline path (current = " << options.output
                   << ")\n"
-                  << "3) set the base state file name (current = " << currentBst
+                  << "3) set the base state path (current = " << options.baseState
                   << ")\n"
-                  << "4) set the constraints file name (current = " << currentCst
+                  << "4) set the constraints path (current = " << options.constraints
                   << ")\n"
                   << "5) help\n"
                   << "6) Exit \n";
@@ -487,29 +435,28 @@ void menuSelection(string &bst, string &cst, string &out) {
             emptyBuffer();
         }
 
+        string path;
         switch (menuSelection) {
             case 1:
                 break;
             case 2:
-                cout << "\nEnter the timeline file name : ";
-                cin >> out;
+                cout << "\nEnter the timeline path : ";
+                cin >> path;
                 emptyBuffer();
-                out = setRelativePath(DEFAULT_PATH, out,
-                                      TIMELINE_EXT);
+                options.output = withExtension(path, TIMELINE_EXT);
                 break;
             case 3:
-                cout << "\nEnter the state file name : ";
-                cin >> bst;
+                cout << "\nEnter the state path : ";
+                cin >> path;
                 emptyBuffer();
-                bst = setRelativePath(DEFAULT_PATH, bst,
-                                      STATE_EXT);
+                options.baseState = withExtension(path, STATE_EXT);
+                options.baseStateGiven = true;
                 break;
             case 4:
-                cout << "\nEnter the constraints file name : ";
-                cin >> cst;
+                cout << "\nEnter the constraints path : ";
+                cin >> path;
                 emptyBuffer();
-                cst = setRelativePath(DEFAULT_PATH, cst,
-                                      CONSTRAINT_EXT);
+                options.constraints = withExtension(path, CONSTRAINT_EXT);
                 break;
             case 5:
                 showMenuHelp();
@@ -523,11 +470,55 @@ void menuSelection(string &bst, string &cst, string &out) {
     } while (menuSelection != 1);
 }
 
+// -x|--name of the option
+static string optionNames(char letter) {
+    for (const OptionName &option: OPTION_NAMES) {
+        if (option.letter == letter)
+            return string("-") + letter + "|--" + option.name;
+    }
+    return string("-") + letter;
+}
+
 string argumentList() {
     stringstream ss;
-    ss << "[-" << BASE_STATE_ARG << " <Base state file name>]\n"
-       << "[-" << CONSTRAINTS_ARG << " <Constraints file name>]\n"
-       << "[-" << OUTPUT_PATH_ARG << " <Output file name>]\n";
+    ss << "[" << optionNames(BASE_STATE_ARG) << " <Base state path>]\n"
+       << "[" << optionNames(CONSTRAINTS_ARG) << " <Constraints path>]\n"
+       << "[" << optionNames(OUTPUT_PATH_ARG) << " <Output path>]\n"
+       << "[" << optionNames(FORMAT_ARG) << " <Output format : json, compact, cbor,"
+       << " msgpack, bson>]\n"
+       << "[" << optionNames(CODEC_ARG) << " <Compressed timeline codec : none, zlib,"
+       << " zstd, lz4>]\n"
+       << "[" << optionNames(CHECKPOINT_ARG) << " <Checkpoint path, its states in"
+       << " the .states file next to it>]\n"
+       << "[" << optionNames(CHECKPOINT_PERIOD_ARG) << " <Seconds between two"
+       << " checkpoints, " << CHECKPOINT_PERIOD << " by default>]\n"
+       << "[" << optionNames(RESUME_ARG) << " <Checkpoint path to resume from>]\n"
+       << "[" << optionNames(FORK_ARG) << " <Timeline or checkpoint path to simulate"
+       << " again from one of its states>]\n"
+       << "[" << optionNames(FORK_TIME_ARG) << " <Time of the fork state>]\n"
+       << "[" << optionNames(FORK_INDEX_ARG) << " <Index of the fork state>]\n"
+       << "With -" << FORK_ARG << ", -" << BASE_STATE_ARG
+       << " gives an edited state replacing the fork state. A checkpoint is\n"
+       << "forked with its modes and constraints, without simulating the states"
+       << " before the fork\n"
+       << "[" << optionNames(STEP_MODE_ARG) << " <Step mode : legacy, twophase>]\n"
+       << "[" << optionNames(THREADS_ARG)
+       << " <Threads used, all the cores by default>]\n"
+       << "[" << optionNames(COMPACT_ARG) << " <Tolerance of the compaction removing"
+       << " the states given by the previous one, " << COMPACT_TOLERANCE
+       << " usually>]\n"
+       << "[" << optionNames(FRAME_RATE_ARG) << " <Frames per second of the"
+       << " simulation, " << DefaultSimConfig::framePerSec << " by default>]\n"
+       << "[" << optionNames(TIME_MODE_ARG) << " <Time mode : float, exact (integer"
+       << " frames and fixed-point positions)>]\n"
+       << "[" << optionNames(MOVE_MODE_ARG) << " <Robot moves : turn (on itself,"
+       << " then straight), arc>]\n"
+       << "[" << optionNames(TARGET_ARG) << " <Targets : nearest (particle), route"
+       << " (planned with the explosion times)>]\n"
+       << "[" << optionNames(QUIET_ARG) << "] No progress messages\n"
+       << "[" << optionNames(STATS_ARG) << "] Statistics of the run at the end\n"
+       << "[" << optionNames(INTERACTIVE_ARG) << "] Menu to choose the files\n"
+       << "[" << optionNames(HELP_ARG) << "] This help\n";
     return ss.str();
 }
 
@@ -535,65 +526,209 @@ void showMenuHelp() {
     cout << "-------------------------Help---------------------------\n";
     cout << "Command line arguments : \n";
     cout << argumentList();
-    cout << "\nThe default path to open files is " << DEFAULT_PATH << "\n";
-    cout << "Please put the origin state file & constraint file there\n";
+    cout << "\nThe relative paths start from " << filesystem::current_path().string()
+         << "\n";
     pause("Press enter to continue...\n");
 }
 
-void showArgHelp() {
-    cout << "Command line arguments : \n";
-    cout << argumentList();
-    cout << "Continue/quit? [y/n]";
-    char key;
-    string error = "Invalid input [y/n], please retry\n";
-    do {
-        while (!(cin >> key)) {
-            cout << error;
-            cin.clear();
-            emptyBuffer();
-        }
-        key = char(tolower(key));
-    } while (key != 'y' && key != 'n');
+void showHelp(ostream &os) {
+    os << "Usage : DeepCleaner_Backend [options]\n"
+       << argumentList()
+       << "A value is given as -x <value>, --name <value> or --name=<value>\n"
+       << "The extension is added to a file name without one, the path "
+       << STANDARD_STREAM << " reads the\nstandard input (one input at most) or "
+       << "writes the standard output, the messages\ngoing to the error output\n";
+}
+
+double parseNumber(const string &value) {
+    size_t end = 0;
+    double number;
+    try {
+        number = stod(value, &end);
+    }
+    catch (logic_error &) {
+        end = 0;
+    }
+    if (end == 0 || end != value.size())
+        throw invalid_argument("Invalid number : " + value);
+    return number;
+}
 
-    if (key == 'n')
-        exit(EXIT_SUCCESS);
+double parseNonNegative(const string &value, const string &name) {
+    double number = parseNumber(value);
+    if (number < 0)
+        throw invalid_argument("Negative " + name + " : " + value);
+    return number;
 }
 
-bool manageArguments(int argc, char *argv[], string &bst, string &cst, string &tln) {
-    printTitle();
-    // No arguments given
-    if (argc <= 1)
-        return false;
-    // Help detection
-    string a = argv[1];
-    if (argc == 2 && (a == HELP1 || a == HELP2 || a == HELP3)) {
-        showArgHelp();
-        return false;
+long parseInteger(const string &value, long minimum, const string &name) {
+    size_t end = 0;
+    long number;
+    try {
+        number = stol(value, &end);
+    }
+    catch (logic_error &) {
+        end = 0;
+    }
+    if (end == 0 || end != value.size())
+        throw invalid_argument("Invalid " + name + ", an integer is expected : "
+                               + value);
+    if (number < minimum)
+        throw invalid_argument("The " + name + " must be at least "
+                               + to_string(minimum) + " : " + value);
+    return number;
+}
+
+void applyOption(char letter, const string &value, Options &options) {
+    switch (letter) {
+        case BASE_STATE_ARG :
+            options.baseState = value == STANDARD_STREAM ? value :
+                                withExtension(value, STATE_EXT);
+            options.baseStateGiven = true;
+            break;
+        case CONSTRAINTS_ARG :
+            options.constraints = value == STANDARD_STREAM ? value :
+                                  withExtension(value, CONSTRAINT_EXT);
+            break;
+        case OUTPUT_PATH_ARG :
+            options.output = value == STANDARD_STREAM ? value :
+                             withExtension(value, TIMELINE_EXT);
+            break;
+        case FORMAT_ARG :
+            if (!parseFormatName(value, options.format))
+                throw invalid_argument("Unknown output format : " + value);
+            break;
+        case CODEC_ARG :
+            if (!parseCodecName(value, options.codec) ||
+                !isCodecAvailable(options.codec))
+                throw invalid_argument("Unavailable compression codec : " + value);
+            options.compressed = true;
+            break;
+        case CHECKPOINT_ARG :
+        case RESUME_ARG :
+            if (value == STANDARD_STREAM)
+                throw invalid_argument("The checkpoints must be files");
+            if (letter == CHECKPOINT_ARG)
+                options.checkpoint = withExtension(value, CHECKPOINT_EXT);
+            else
+                options.resume = withExtension(value, CHECKPOINT_EXT);
+            break;
+        case CHECKPOINT_PERIOD_ARG :
+            options.checkpointPeriod = parseNonNegative(value, "checkpoint period");
+            break;
+        case FORK_ARG :
+            options.fork = value == STANDARD_STREAM ? value :
+                           withExtension(value, TIMELINE_EXT);
+            break;
+        case FORK_TIME_ARG :
+            options.forkTime = parseNumber(value);
+            break;
+        case FORK_INDEX_ARG :
+            options.forkIndex = parseInteger(value, 0, "fork index");
+            break;
+        case STEP_MODE_ARG :
+            if (value != "legacy" && value != "twophase")
+                throw invalid_argument("Unknown step mode : " + value);
+            options.stepModeGiven = true;
+            options.stepMode = value == "twophase" ? TWO_PHASE_STEP : LEGACY_STEP;
+            break;
+        case THREADS_ARG :
+            options.threads = unsigned(parseInteger(value, 0, "thread count"));
+            break;
+        case COMPACT_ARG :
+            options.compactTolerance = parseNonNegative(value, "compaction tolerance");
+            break;
+        case FRAME_RATE_ARG :
+            options.framePerSec = int(parseInteger(value, 1, "frame rate"));
+            break;
+        case TIME_MODE_ARG :
+            if (value != "float" && value != "exact")
+                throw invalid_argument("Unknown time mode : " + value);
+            options.exact = value == "exact";
+            break;
+        case MOVE_MODE_ARG :
+            if (value != "turn" && value != "arc")
+                throw invalid_argument("Unknown robot moves : " + value);
+            options.moveModeGiven = true;
+            options.moveMode = value == "arc" ? ARC_MOVES : TURN_AND_GO;
+            break;
+        case TARGET_ARG :
+            if (value != "nearest" && value != "route")
+                throw invalid_argument("Unknown targets : " + value);
+            options.targetModeGiven = true;
+            options.targetMode = value == "route" ? ROUTED_TARGETS : NEAREST_TARGET;
+            break;
+        case QUIET_ARG :
+            options.quiet = true;
+            break;
+        case STATS_ARG :
+            options.stats = true;
+            break;
+        case INTERACTIVE_ARG :
+            options.interactive = true;
+            break;
+        case HELP_ARG :
+            options.help = true;
+            break;
+        default :
+            throw invalid_argument(string("Unknown option -") + letter);
     }
-    if (argc == 7) {
-        for (int i = 0; i < argc; ++i) {
-            string arg = argv[i];
-            //Letter detection
-            if (arg.size() == 2) {
-                string path = argv[i + 1];
-                switch (arg.at(1)) {
-                    case BASE_STATE_ARG :
-                        bst = setRelativePath(DEFAULT_PATH, path, STATE_EXT);
-                        break;
-                    case CONSTRAINTS_ARG :
-                        cst = setRelativePath(DEFAULT_PATH, path, CONSTRAINT_EXT);
-                        break;
-                    case OUTPUT_PATH_ARG :
-                        tln = setRelativePath(DEFAULT_PATH, path, TIMELINE_EXT);
-                        break;
-                    default :
-                        break;
-                }
+}
+
+void manageArguments(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == HELP1 || arg == HELP2)
+            arg = string("-") + HELP_ARG;
+
+        // --name, --name=value or -x
+        const OptionName *option = nullptr;
+        string value;
+        bool inlineValue = false;
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            size_t equal = arg.find('=');
+            string name = arg.substr(2, equal == string::npos ? string::npos
+                                                              : equal - 2);
+            if (equal != string::npos) {
+                value = arg.substr(equal + 1);
+                inlineValue = true;
+            }
+            for (const OptionName &o: OPTION_NAMES) {
+                if (o.name == name)
+                    option = &o;
+            }
+        } else if (arg.size() == 2 && arg[0] == '-') {
+            for (const OptionName &o: OPTION_NAMES) {
+                if (o.letter == arg[1])
+                    option = &o;
             }
+        } else {
+            throw invalid_argument("Unexpected argument : " + arg);
         }
-        return true;
+        if (option == nullptr)
+            throw invalid_argument("Unknown option : " + arg);
+
+        if (option->hasValue && !inlineValue) {
+            if (i + 1 >= argc)
+                throw invalid_argument("Missing value of " + arg);
+            value = argv[++i];
+        } else if (!option->hasValue && inlineValue) {
+            throw invalid_argument("No value expected for --" + option->name);
+        }
+        applyOption(option->letter, value, options);
     }
-    cout << "Please give the following arguments : \n" << argumentList()
-         << "The program will close.\n";
-    exit(EXIT_FAILURE);
+
+    // A single reader of the standard input
+    int standardInputs = 0;
+    if (options.baseStateGiven && options.baseState == STANDARD_STREAM)
+        ++standardInputs;
+    if (options.constraints == STANDARD_STREAM)
+        ++standardInputs;
+    if (options.fork == STANDARD_STREAM)
+        ++standardInputs;
+    if (standardInputs > 1)
+        throw invalid_argument("Only one input can be read from the standard input");
+    if (standardInputs > 0 && options.interactive)
+        throw invalid_argument("The menu reads the standard input, give the "
+                               "inputs as files");
 }
@@ -13,9 +13,31 @@ Particle::Particle(int id, Position position, double radius,
 	this->id = id;
 	this->position = position;
 	this->radius = radius;
-	this->explosionTimes = explosionTimes;
+	this->explosionTimes = std::make_shared<const ExplosionTimes>(
+		std::move(explosionTimes));
 }
 
-bool Particle::hasChild() {
-	return !this->explosionTimes[1].empty();
+const std::shared_ptr<const ExplosionTimes> &Particle::noExplosionTimes() {
+	static const std::shared_ptr<const ExplosionTimes> empty =
+		std::make_shared<const ExplosionTimes>();
+	return empty;
+}
+
+void to_json(nlohmann::json &j, const Particle &p) {
+	j = nlohmann::json{{"id",             p.id},
+							 {"position",       p.position},
+							 {"radius",         p.radius},
+							 {"explosionTimes", *p.explosionTimes}};
+}
+
+void from_json(const nlohmann::json &j, Particle &p) {
+	j.at("id").get_to(p.id);
+	j.at("position").get_to(p.position);
+	j.at("radius").get_to(p.radius);
+	p.explosionTimes = std::make_shared<const ExplosionTimes>(
+		j.at("explosionTimes").get<ExplosionTimes>());
+}
+
+bool Particle::hasChild() const {
+	return !(*this->explosionTimes)[1].empty();
 }
@@ -9,6 +9,7 @@ Compiler : Mingw-w64 g++ 11.2.0
 #ifndef PARTICLE_H
 #define PARTICLE_H
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "position.h"
@@ -21,29 +22,34 @@ public:
 	Particle(int id, Position position, double radius,
 				std::vector<std::vector<double>> explosionTimes);
 
-	Particle() : id(0), position(Position()), radius(0), explosionTimes
-		(std::vector<std::vector<double>>()) {}
+	Particle() : id(0), position(Position()), radius(0),
+					 explosionTimes(noExplosionTimes()) {}
 
-	bool hasChild();
+	bool hasChild() const;
 
 	std::vector<Particle> explode();
 
-	Position getPosition() { return position; }
+	const Position &getPosition() const { return position; }
 
 	double getRadius() const { return radius; }
 
 	int getId() const { return id; }
 
-    ExplosionTimes* getExplosionTime(){return &explosionTimes;}
+	const ExplosionTimes &getExplosionTimes() const { return *explosionTimes; }
+
+	friend void to_json(nlohmann::json &j, const Particle &p);
+
+	friend void from_json(const nlohmann::json &j, Particle &p);
 
 private:
 
 	int id;             // unique identifier
 	Position position;  // (x,y) coordinates of the particle
 	double radius;      // radius of the circular particle
-	std::vector<std::vector<double>> explosionTimes;
+	// Never modified, shared by the copies of the particle in every state
+	std::shared_ptr<const ExplosionTimes> explosionTimes;
 
-	NLOHMANN_DEFINE_TYPE_INTRUSIVE(Particle, id, position, radius, explosionTimes)
+	static const std::shared_ptr<const ExplosionTimes> &noExplosionTimes();
 };
 
 #endif // PARTICLE_H
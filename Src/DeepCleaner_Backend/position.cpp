@@ -12,11 +12,3 @@ Position::Position(double x, double y) {
 	this->x = x;
 	this->y = y;
 }
-
-double Position::getX() {
-	return this->x;
-}
-
-double Position::getY() {
-	return this->y;
-}
@@ -8,6 +8,7 @@ Compiler : Mingw-w64 g++ 11.2.0
 
 #include "robot.h"
 #include "trajectory.h"
+#include "kinematics.h"
 #include <fstream>
 
 Robot::Robot(int id, Position position, double radius, double angle,
@@ -22,8 +23,56 @@ Robot::Robot(int id, Position position, double radius, double angle,
 	this->score = 0;
 }
 
+// The degrees read if the angle is still the one they gave
+static double inDegrees(double radians, double fileDegrees) {
+	return toRad(fileDegrees) == radians ? fileDegrees : toDeg(radians);
+}
+
 double Robot::getAngle(AngleUnit unit) const {
-	if (unit == RAD)
-		return toRad(this->angle);
+	if (unit == DEG)
+		return inDegrees(this->angle, this->fileAngle);
 	return this->angle;
-}
\ No newline at end of file
+}
+
+double Robot::getCaptureAngle(AngleUnit unit) const {
+	if (unit == DEG)
+		return inDegrees(this->captureAngle, this->fileCaptureAngle);
+	return this->captureAngle;
+}
+
+void Robot::setFileAngles(double angleDeg, double captureAngleDeg) {
+	this->angle = toRad(angleDeg);
+	this->captureAngle = toRad(captureAngleDeg);
+	this->fileAngle = angleDeg;
+	this->fileCaptureAngle = captureAngleDeg;
+}
+
+void to_json(nlohmann::json &j, const Robot &r) {
+	j = nlohmann::json{{"id",           r.id},
+							 {"position",     r.position},
+							 {"radius",       r.radius},
+							 {"angle",        r.getAngle(DEG)},
+							 {"captureAngle", r.getCaptureAngle(DEG)},
+							 {"leftSpeed",    r.leftSpeed},
+							 {"rightSpeed",   r.rightSpeed},
+							 {"score",        r.score}};
+}
+
+void from_json(const nlohmann::json &j, Robot &r) {
+	j.at("id").get_to(r.id);
+	j.at("position").get_to(r.position);
+	j.at("radius").get_to(r.radius);
+	r.setFileAngles(j.at("angle").get<double>(), j.at("captureAngle").get<double>());
+	j.at("leftSpeed").get_to(r.leftSpeed);
+	j.at("rightSpeed").get_to(r.rightSpeed);
+	j.at("score").get_to(r.score);
+}
+
+Robot Robot::movedFor(double deltaTime) const {
+	Robot moved = *this;
+	Pose pose = advancePose({position, angle}, radius, leftSpeed, rightSpeed,
+									deltaTime);
+	moved.position = pose.position;
+	moved.angle = pose.angle;
+	return moved;
+}
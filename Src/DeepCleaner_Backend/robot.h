@@ -9,6 +9,7 @@ Compiler : Mingw-w64 g++ 11.2.0
 #ifndef ROBOT_H
 #define ROBOT_H
 
+#include <cmath>
 #include "position.h"
 
 using json = nlohmann::json;
@@ -23,12 +24,19 @@ public:
 	Robot() : id(0), position(Position()), radius(0), angle(0), captureAngle(0),
 				 leftSpeed(0), rightSpeed(0), score(0) {}
 
+	// Angles in radians, the files give them in degrees
 	Robot(int id, Position position, double radius, double angle, double
 	captureAngle, double leftSpeed, double rightSpeed);
 
 	double getAngle(AngleUnit unit = RAD) const;
 
-	Position getPosition() const { return position; }
+	double getCaptureAngle(AngleUnit unit = RAD) const;
+
+	// Robot after deltaTime seconds at its wheel speeds, in a line, rotating
+	// on itself or on an arc
+	Robot movedFor(double deltaTime) const;
+
+	const Position &getPosition() const { return position; }
 
 	double getRadius() const { return radius; }
 
@@ -46,31 +54,42 @@ public:
 
     int getTargetParticleId() const {return targetParticleId;}
 
-    double getScore(){return score;}
+    double getScore() const {return score;}
 
     void setTargetParticleId(int _id){targetParticleId = _id;}
 
 	void setPosition(Position pos) { position = pos; }
 
-	void setAngle(double _angle) { angle = _angle; }
+	void setAngle(double _angle) { angle = _angle; } // radians
+
+	// Angles of a file, in degrees. They are written back as they were read
+	// while the robot keeps them, a round trip in radians is not exact
+	void setFileAngles(double angleDeg, double captureAngleDeg);
+
+	// Angles set to what the files give back once written in degrees
+	void roundToFileAngles() { setFileAngles(getAngle(DEG), getCaptureAngle(DEG)); }
 
 	void setBothSpeed(double speed) { setSpeed(speed, speed); }
 
     void setScore(double newScore){ score = newScore;}
+
+	// The angles are written in degrees, as in the files of the UI
+	friend void to_json(nlohmann::json &j, const Robot &r);
+
+	friend void from_json(const nlohmann::json &j, Robot &r);
+
 private:
     int targetParticleId = -1;
 	int id;              // unique identifier
 	Position position;   // (x,y) coordinates of the robot in the world (in pixels)
 	double radius;       // radius of the circular robot. (pixels)
-	double angle;        // direction in which the robot moves. [0,360[ in degrees. 0 = 3 o'clock, 90 = noon
-	double captureAngle; // c.f. décontamination
+	double angle;        // direction in which the robot moves. [0,2pi[ in radians. 0 = 3 o'clock, pi/2 = noon
+	double captureAngle; // c.f. décontamination, radians
 	double leftSpeed;    // linear speed of the leftmost part of the robot in pixels/sec
 	double rightSpeed;   // linear speed of the rightmost part of the robot in pixels/sec
 	double score;        // c.f. décontamination
-
-	NLOHMANN_DEFINE_TYPE_INTRUSIVE(Robot, id, position, radius, angle,
-											 captureAngle, leftSpeed, rightSpeed, score)
-
+	double fileAngle = NAN;        // degrees read for angle, if any
+	double fileCaptureAngle = NAN; // degrees read for captureAngle, if any
 };
 
 #endif // ROBOT_H
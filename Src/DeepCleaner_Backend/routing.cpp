@@ -0,0 +1,444 @@
+/*-----------------------------------------------------------------------------
+File name : routing.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the route planner. A route costs the sum of
+the arrival times weighted by the area of the particles, plus a penalty for
+the ones reached after their explosion. The travel is estimated like the
+simulation moves : a rotation then a line, each ending at a command time, the
+robot stopping at the contact facing the particle. The moves only put a
+particle next to one of its nearest neighbours.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "routing.h"
+#include "fasttrig.h"
+#include "trajectory.h"
+#include "utils.h"
+
+// Smallest decrease of the cost accepted, the moves stop on ties
+const double MIN_GAIN = 1e-6;
+
+void RoutePlanner::plan(const std::vector<Robot> &robots,
+								const std::vector<Particle> &particles,
+								const Constraints &constraints, double time,
+								const CostMatrix &matrix) {
+	routes.clear();
+	rebuild(robots, particles, constraints, time, matrix, false);
+	std::fill(active.begin(), active.end(), 1);
+	improve(PLAN_PASSES);
+	setRoutesFromWork(robots);
+}
+
+void RoutePlanner::update(const std::vector<Robot> &robots,
+								  const std::vector<Particle> &particles,
+								  const Constraints &constraints, double time,
+								  const CostMatrix &matrix) {
+	currentIds.clear();
+	for (const Particle &p: particles)
+		currentIds.push_back(p.getId());
+	std::sort(currentIds.begin(), currentIds.end());
+	if (currentIds == knownIds && routes.size() == robots.size())
+		return;
+
+	rebuild(robots, particles, constraints, time, matrix, true);
+	improve(UPDATE_PASSES);
+	setRoutesFromWork(robots);
+}
+
+int RoutePlanner::getTarget(int robotId) const {
+	auto route = routes.find(robotId);
+	if (route == routes.end() || route->second.empty())
+		return -1;
+	return route->second.front();
+}
+
+void RoutePlanner::rebuild(const std::vector<Robot> &robots,
+									const std::vector<Particle> &particles,
+									const Constraints &constraints, double time,
+									const CostMatrix &matrix, bool keepHeads) {
+	captureCosts = &matrix;
+	startTime = time;
+	rotationSpeed = std::min(constraints.maxBackwardSpeed, constraints.maxForwardSpeed);
+	forwardSpeed = constraints.maxForwardSpeed;
+	commandInterval = constraints.commandTimeInterval;
+
+	// Stops in the order of the ids, found by a binary search on knownIds
+	sorted.clear();
+	for (const Particle &p: particles)
+		sorted.push_back(&p);
+	std::sort(sorted.begin(), sorted.end(), [](const Particle *a, const Particle *b) {
+		return a->getId() < b->getId();
+	});
+	stops.clear();
+	knownIds.clear();
+	for (const Particle *p: sorted) {
+		const ExplosionTimes &times = p->getExplosionTimes();
+		double deadline = times.empty() || times[0].empty()
+								? std::numeric_limits<double>::infinity() : times[0][0];
+		stops.push_back({p->getId(), p->getPosition(), p->getRadius(),
+							  getArea(p->getRadius()), deadline,
+							  std::size_t(p - particles.data())});
+		knownIds.push_back(p->getId());
+	}
+	sortByX();
+
+	std::size_t count = robots.size();
+	starts.resize(count);
+	work.resize(count);
+	arrivals.resize(count);
+	prefixCosts.resize(count);
+	costs.resize(count);
+	fixedHead.assign(count, 0);
+	active.assign(count, 0);
+	reserveFor(routeOf, stops.size());
+	routeOf.assign(stops.size(), -1);
+	// A route never has more stops than the particles
+	reserveFor(scratch, stops.size());
+	reserveFor(removedStops, stops.size());
+	for (std::size_t r = 0; r < count; ++r) {
+		const Robot &robot = robots[r];
+		starts[r] = {robot.getPosition(), robot.getRadius()};
+		work[r].clear();
+		auto old = routes.find(robot.getId());
+		if (old == routes.end()) {
+			active[r] = 1;
+		} else {
+			// The eaten and exploded particles are left out
+			for (int id: old->second) {
+				auto found = std::lower_bound(knownIds.begin(), knownIds.end(), id);
+				int stop = int(found - knownIds.begin());
+				if (found == knownIds.end() || *found != id || routeOf[stop] != -1) {
+					active[r] = 1;
+					continue;
+				}
+				routeOf[stop] = int(r);
+				work[r].push_back(stop);
+			}
+		}
+		fixedHead[r] = keepHeads && !work[r].empty() &&
+							stops[work[r][0]].id == robot.getTargetParticleId();
+		refresh(r);
+	}
+
+	// New particles, the first to explode first, then in the order of the ids
+	pending.clear();
+	for (std::size_t s = 0; s < stops.size(); ++s) {
+		if (routeOf[s] == -1)
+			pending.push_back(int(s));
+	}
+	std::sort(pending.begin(), pending.end(), [this](int a, int b) {
+		return stops[a].deadline < stops[b].deadline ||
+				 (stops[a].deadline == stops[b].deadline && a < b);
+	});
+	for (int stop: pending)
+		insert(stop);
+}
+
+void RoutePlanner::setRoutesFromWork(const std::vector<Robot> &robots) {
+	// The routes of the robots still there are written over, not allocated
+	// again
+	for (std::size_t r = 0; r < robots.size(); ++r) {
+		std::vector<int> &ids = routes[robots[r].getId()];
+		ids.clear();
+		for (int stop: work[r])
+			ids.push_back(stops[stop].id);
+	}
+	if (routes.size() == robots.size())
+		return;
+	for (auto route = routes.begin(); route != routes.end();) {
+		bool kept = std::any_of(robots.begin(), robots.end(), [&](const Robot &r) {
+			return r.getId() == route->first;
+		});
+		route = kept ? std::next(route) : routes.erase(route);
+	}
+}
+
+void RoutePlanner::sortByX() {
+	std::size_t count = stops.size();
+	byX.resize(count);
+	rank.resize(count);
+	std::iota(byX.begin(), byX.end(), 0);
+	std::sort(byX.begin(), byX.end(), [this](int a, int b) {
+		return stops[a].position.getX() < stops[b].position.getX();
+	});
+	for (std::size_t k = 0; k < count; ++k)
+		rank[byX[k]] = int(k);
+	reserveFor(neighbours, count * ROUTE_NEIGHBOURS);
+	reserveFor(hasNeighbours, count);
+	neighbours.assign(count * ROUTE_NEIGHBOURS, -1);
+	hasNeighbours.assign(count, 0);
+}
+
+const int *RoutePlanner::neighboursOf(int stop) {
+	int *nearestIds = &neighbours[std::size_t(stop) * ROUTE_NEIGHBOURS];
+	if (hasNeighbours[stop])
+		return nearestIds;
+	hasNeighbours[stop] = 1;
+
+	// Sweep along the stops ordered by x, until the gap in x is larger than
+	// the furthest of the nearest ones found
+	const Position &from = stops[stop].position;
+	std::pair<double, int> nearest[ROUTE_NEIGHBOURS];
+	int found = 0;
+	for (int step: {-1, 1}) {
+		for (long k = rank[stop] + step; k >= 0 && k < long(byX.size()); k += step) {
+			const Position &to = stops[byX[k]].position;
+			double dx = to.getX() - from.getX(), dy = to.getY() - from.getY();
+			if (found == ROUTE_NEIGHBOURS && dx * dx >= nearest[found - 1].first)
+				break;
+			std::pair<double, int> candidate(dx * dx + dy * dy, byX[k]);
+			if (found == ROUTE_NEIGHBOURS) {
+				if (candidate >= nearest[found - 1])
+					continue;
+				--found;
+			}
+			int i = found++;
+			for (; i > 0 && candidate < nearest[i - 1]; --i)
+				nearest[i] = nearest[i - 1];
+			nearest[i] = candidate;
+		}
+	}
+	for (int i = 0; i < found; ++i)
+		nearestIds[i] = nearest[i].second;
+	return nearestIds;
+}
+
+double RoutePlanner::commandTime(double time) const {
+	return roundUp(time);
+}
+
+double RoutePlanner::legTime(std::size_t route, const std::vector<int> &sequence,
+									  std::size_t index, double time) const {
+	const Start &start = starts[route];
+	const Stop &stop = stops[sequence[index]];
+	if (index == 0) {
+		// The first move starts at the next command time
+		double rotation = captureCosts->getRotationTime(route, stop.column);
+		double end = rotation > 0 ? commandTime(time + rotation) : time;
+		return commandTime(end + captureCosts->getLineTime(route, stop.column)) - time;
+	}
+
+	// The robot is taken at the center of the previous particle, facing the
+	// way it came from
+	const Position &from = stops[sequence[index - 1]].position;
+	const Position &before = index > 1 ? stops[sequence[index - 2]].position
+												  : start.position;
+	double headingX = from.getX() - before.getX();
+	double headingY = from.getY() - before.getY();
+	double dx = stop.position.getX() - from.getX();
+	double dy = stop.position.getY() - from.getY();
+	double distance = std::sqrt(dx * dx + dy * dy);
+	double reach = start.radius + stop.radius;
+	if (distance <= reach)
+		return 0.0;
+
+	// Angle between the heading and the stop, from their cross and dot products
+	double turn = std::abs(fastAtan2(headingX * dy - headingY * dx,
+												headingX * dx + headingY * dy));
+	double rotation = turn > captureCosts->getAngleTolerance()
+							? turn * start.radius / rotationSpeed : 0.0;
+	double line = (distance - reach) / forwardSpeed;
+	return roundUp(rotation) + roundUp(line);
+}
+
+double RoutePlanner::stopCost(const Stop &stop, double time) const {
+	double cost = stop.area * (time - startTime);
+	if (time > stop.deadline)
+		cost += EXPLOSION_PENALTY * stop.area;
+	return cost;
+}
+
+void RoutePlanner::refresh(std::size_t route) {
+	const std::vector<int> &sequence = work[route];
+	std::vector<double> &times = arrivals[route], &sums = prefixCosts[route];
+	times.resize(sequence.size());
+	sums.resize(sequence.size());
+	double time = startTime, cost = 0.0;
+	for (std::size_t k = 0; k < sequence.size(); ++k) {
+		time += legTime(route, sequence, k, time);
+		cost += stopCost(stops[sequence[k]], time);
+		times[k] = time;
+		sums[k] = cost;
+	}
+	costs[route] = cost;
+}
+
+double RoutePlanner::routeCost(std::size_t route,
+										 const std::vector<int> &sequence) const {
+	const std::vector<int> &current = work[route];
+	const std::vector<double> &times = arrivals[route];
+	std::size_t n = sequence.size(), m = current.size();
+	std::size_t prefix = 0, suffix = 0;
+	while (prefix < std::min(n, m) && sequence[prefix] == current[prefix])
+		++prefix;
+	while (suffix < std::min(n, m) - prefix &&
+			 sequence[n - 1 - suffix] == current[m - 1 - suffix])
+		++suffix;
+	if (prefix == n && n == m)
+		return costs[route];
+
+	// A leg depends on the two stops before it, from the third stop of the
+	// common end the legs are the same and only shifted in time
+	std::size_t shiftedFrom = suffix > 2 ? n - suffix + 2 : n;
+	double time = prefix > 0 ? times[prefix - 1] : startTime;
+	double cost = prefix > 0 ? prefixCosts[route][prefix - 1] : 0.0;
+	for (std::size_t k = prefix; k < shiftedFrom; ++k) {
+		time += legTime(route, sequence, k, time);
+		cost += stopCost(stops[sequence[k]], time);
+	}
+	if (shiftedFrom < n) {
+		double shift = time - times[shiftedFrom - 1 + m - n];
+		for (std::size_t k = shiftedFrom; k < n; ++k)
+			cost += stopCost(stops[sequence[k]], times[k + m - n] + shift);
+	}
+	return cost;
+}
+
+double RoutePlanner::roundUp(double duration) const {
+	return commandDuration(duration, commandInterval);
+}
+
+void RoutePlanner::insert(int stop) {
+	// Cheapest of the ends of the routes and the places next to a neighbour
+	double bestDelta = std::numeric_limits<double>::infinity();
+	std::size_t bestRoute = 0, bestIndex = 0;
+	auto tryAt = [&](std::size_t route, std::size_t index) {
+		if (index < firstMovable(route))
+			return;
+		scratch = work[route];
+		scratch.insert(scratch.begin() + long(index), stop);
+		double delta = routeCost(route, scratch) - costs[route];
+		if (delta < bestDelta) {
+			bestDelta = delta;
+			bestRoute = route;
+			bestIndex = index;
+		}
+	};
+	for (std::size_t r = 0; r < work.size(); ++r)
+		tryAt(r, work[r].size());
+	const int *nearest = neighboursOf(stop);
+	for (int i = 0; i < ROUTE_NEIGHBOURS; ++i) {
+		int neighbour = nearest[i];
+		if (neighbour == -1)
+			break;
+		if (routeOf[neighbour] == -1)
+			continue;
+		std::size_t route = routeOf[neighbour];
+		const std::vector<int> &sequence = work[route];
+		std::size_t index = std::find(sequence.begin(), sequence.end(), neighbour)
+								  - sequence.begin();
+		tryAt(route, index);
+		tryAt(route, index + 1);
+	}
+	if (bestDelta == std::numeric_limits<double>::infinity())
+		return;
+
+	scratch = work[bestRoute];
+	scratch.insert(scratch.begin() + long(bestIndex), stop);
+	setRoute(bestRoute, scratch);
+}
+
+void RoutePlanner::setRoute(std::size_t route, const std::vector<int> &sequence) {
+	reserveFor(work[route], sequence.size());
+	work[route] = sequence;
+	refresh(route);
+	for (int stop: sequence)
+		routeOf[stop] = int(route);
+	active[route] = 1;
+}
+
+void RoutePlanner::improve(int passes) {
+	for (int pass = 0; pass < passes; ++pass) {
+		bool improved = false;
+		for (std::size_t r = 0; r < work.size(); ++r) {
+			if (!active[r])
+				continue;
+			active[r] = 0;
+			improved |= twoOpt(r);
+			improved |= orOpt(r);
+		}
+		if (!improved)
+			break;
+	}
+}
+
+bool RoutePlanner::twoOpt(std::size_t route) {
+	bool improved = false;
+	for (std::size_t i = firstMovable(route); i + 1 < work[route].size(); ++i) {
+		for (std::size_t j = i + 1; j < work[route].size(); ++j) {
+			scratch = work[route];
+			std::reverse(scratch.begin() + long(i), scratch.begin() + long(j) + 1);
+			if (routeCost(route, scratch) < costs[route] - MIN_GAIN) {
+				setRoute(route, scratch);
+				improved = true;
+			}
+		}
+	}
+	return improved;
+}
+
+bool RoutePlanner::orOpt(std::size_t route) {
+	bool improved = false;
+	std::vector<int> &moved = movedStops, &removed = removedStops;
+	for (std::size_t i = firstMovable(route); i < work[route].size(); ++i) {
+		for (std::size_t length = 1; length <= std::size_t(MAX_MOVED_SEGMENT) &&
+											  i + length <= work[route].size(); ++length) {
+			const std::vector<int> &sequence = work[route];
+			moved.assign(sequence.begin() + long(i), sequence.begin() + long(i + length));
+			removed = sequence;
+			removed.erase(removed.begin() + long(i), removed.begin() + long(i + length));
+			double removedCost = routeCost(route, removed);
+
+			// Before or after a neighbour of an end of the segment, or alone
+			// in an empty route
+			bool done = false;
+			auto tryAt = [&](std::size_t other, std::size_t index) {
+				if (done || index < firstMovable(other))
+					return;
+				scratch = other == route ? removed : work[other];
+				scratch.insert(scratch.begin() + long(index), moved.begin(), moved.end());
+				double cost = routeCost(other, scratch);
+				double gain = other == route
+								  ? costs[route] - cost
+								  : costs[route] + costs[other] - removedCost - cost;
+				if (gain <= MIN_GAIN)
+					return;
+				if (other != route)
+					setRoute(route, removed);
+				setRoute(other, scratch);
+				done = true;
+			};
+			for (int end: {moved.front(), moved.back()}) {
+				const int *nearest = neighboursOf(end);
+				for (int k = 0; k < ROUTE_NEIGHBOURS && !done; ++k) {
+					int neighbour = nearest[k];
+					if (neighbour == -1)
+						break;
+					if (routeOf[neighbour] == -1 ||
+						 std::find(moved.begin(), moved.end(), neighbour) != moved.end())
+						continue;
+					std::size_t other = routeOf[neighbour];
+					const std::vector<int> &base = other == route ? removed : work[other];
+					std::size_t index = std::find(base.begin(), base.end(), neighbour)
+											  - base.begin();
+					tryAt(other, index);
+					tryAt(other, index + 1);
+				}
+			}
+			for (std::size_t other = 0; other < work.size() && !done; ++other) {
+				if (work[other].empty())
+					tryAt(other, 0);
+			}
+			if (done) {
+				improved = true;
+				break;
+			}
+		}
+	}
+	return improved;
+}
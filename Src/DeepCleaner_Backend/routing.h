@@ -0,0 +1,153 @@
+/*-----------------------------------------------------------------------------
+File name : routing.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the route planner of the robots. Every robot gets a
+sequence of particles, chosen for the time it takes to turn and go to each of
+them and for the explosion time of the particles, an exploded particle being
+harder to collect. The routes are built by insertion then improved by 2-opt
+and Or-opt moves, and after an event only the routes that changed are
+improved again.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef ROUTING_H
+#define ROUTING_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "costmatrix.h"
+#include "particle.h"
+#include "robot.h"
+#include "timeline.h"
+
+// Cost of a particle reached after its explosion, in seconds of delay of the
+// same area
+const double EXPLOSION_PENALTY = 30.0;
+// Particles near a particle where the moves may put it
+const int ROUTE_NEIGHBOURS = 8;
+// Longest sequence of particles moved at once by Or-opt
+const int MAX_MOVED_SEGMENT = 3;
+// Improvement passes over the routes for a new plan and after an event
+const int PLAN_PASSES = 20;
+const int UPDATE_PASSES = 4;
+
+// Particle ids to visit in order, by robot id
+using Routes = std::map<int, std::vector<int>>;
+
+class RoutePlanner {
+
+public:
+	// New routes for every robot at the given time. The first move of every
+	// robot is read from matrix, updated with the same robots and particles
+	void plan(const std::vector<Robot> &robots,
+				 const std::vector<Particle> &particles,
+				 const Constraints &constraints, double time, const CostMatrix &matrix);
+
+	// The eaten and exploded particles leave the routes and the new ones are
+	// inserted. The robots keep the particle they are going to. Nothing is
+	// done if the particles did not change
+	void update(const std::vector<Robot> &robots,
+					const std::vector<Particle> &particles,
+					const Constraints &constraints, double time,
+					const CostMatrix &matrix);
+
+	// First particle of the route of the robot, -1 if it has none
+	int getTarget(int robotId) const;
+
+	const Routes &getRoutes() const { return routes; }
+
+	// Saved in the checkpoints, the working data is rebuilt by every call
+	NLOHMANN_DEFINE_TYPE_INTRUSIVE(RoutePlanner, routes, knownIds)
+
+private:
+	struct Stop {
+		int id = -1;
+		Position position;
+		double radius = 0.0;
+		double area = 0.0;
+		double deadline = 0.0; // first explosion time, infinite if none
+		std::size_t column = 0; // of the particle in the cost matrix
+	};
+
+	struct Start {
+		Position position;
+		double radius = 0.0;
+	};
+
+	Routes routes;
+	std::vector<int> knownIds; // sorted ids of the particles of the last call
+
+	// Working data of a call, stops and routes by index
+	std::vector<Stop> stops;
+	std::vector<int> byX;        // stops ordered by x
+	std::vector<int> rank;       // place of every stop in byX
+	std::vector<int> neighbours; // ROUTE_NEIGHBOURS per stop, -1 if fewer
+	std::vector<char> hasNeighbours; // found on the first use
+	std::vector<Start> starts;
+	std::vector<std::vector<int>> work;
+	std::vector<std::vector<double>> arrivals;    // time at every stop
+	std::vector<std::vector<double>> prefixCosts; // cost up to every stop
+	std::vector<double> costs;
+	std::vector<int> routeOf;    // route of every stop, -1 if not routed
+	std::vector<char> fixedHead; // the robot is going to the first stop
+	std::vector<char> active;    // route changed since its last improvement
+	std::vector<int> scratch;
+	std::vector<int> currentIds; // sorted ids of the particles of the call
+	std::vector<const Particle *> sorted;
+	std::vector<int> pending;
+	std::vector<int> movedStops;
+	std::vector<int> removedStops;
+	const CostMatrix *captureCosts = nullptr; // of the current call
+	double startTime = 0.0;
+	double rotationSpeed = 0.0;
+	double forwardSpeed = 0.0;
+	double commandInterval = 0.0;
+
+	void rebuild(const std::vector<Robot> &robots,
+					 const std::vector<Particle> &particles,
+					 const Constraints &constraints, double time,
+					 const CostMatrix &matrix, bool keepHeads);
+
+	void setRoutesFromWork(const std::vector<Robot> &robots);
+
+	void sortByX();
+
+	// Nearest stops, nearest first
+	const int *neighboursOf(int stop);
+
+	// Time from the previous stop, or from the robot for the first one
+	double legTime(std::size_t route, const std::vector<int> &sequence,
+						std::size_t index, double time) const;
+
+	double stopCost(const Stop &stop, double time) const;
+
+	// Arrival times and cost of the route
+	void refresh(std::size_t route);
+
+	// Cost of the route of the robot if it was sequence. Only the legs that
+	// differ from the current route are computed
+	double routeCost(std::size_t route, const std::vector<int> &sequence) const;
+
+	double commandTime(double time) const;
+
+	// Duration rounded up to whole command intervals
+	double roundUp(double duration) const;
+
+	void insert(int stop);
+
+	void improve(int passes);
+
+	bool twoOpt(std::size_t route);
+
+	bool orOpt(std::size_t route);
+
+	void setRoute(std::size_t route, const std::vector<int> &sequence);
+
+	std::size_t firstMovable(std::size_t route) const {
+		return fixedHead[route] ? 1 : 0;
+	}
+};
+
+#endif // ROUTING_H
@@ -0,0 +1,294 @@
+/*-----------------------------------------------------------------------------
+File name : saxreader.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the streaming reader
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <span>
+#include <stdexcept>
+#include "saxreader.h"
+#include "fileformat.h"
+#include "blockfile.h"
+#include "trajectory.h"
+
+const std::pair<const char *, ModelSaxReader::Field> ModelSaxReader::FIELD_NAMES[] = {
+	{"states",          Field::STATES},
+	{"time",            Field::TIME},
+	{"worldOrigin",     Field::WORLD_ORIGIN},
+	{"worldEnd",        Field::WORLD_END},
+	{"robots",          Field::ROBOTS},
+	{"particles",       Field::PARTICLES},
+	{"id",              Field::ID},
+	{"position",        Field::POSITION},
+	{"radius",          Field::RADIUS},
+	{"angle",           Field::ANGLE},
+	{"captureAngle",    Field::CAPTURE_ANGLE},
+	{"leftSpeed",       Field::LEFT_SPEED},
+	{"rightSpeed",      Field::RIGHT_SPEED},
+	{"score",           Field::SCORE},
+	{"explosionTimes",  Field::EXPLOSION_TIMES},
+	{"x",               Field::X},
+	{"y",               Field::Y}};
+
+ModelSaxReader::Field ModelSaxReader::toField(const std::string &key) {
+	for (const auto &[name, field]: FIELD_NAMES) {
+		if (key == name)
+			return field;
+	}
+	return Field::NONE;
+}
+
+const char *ModelSaxReader::fieldName(Field field) {
+	for (const auto &[name, f]: FIELD_NAMES) {
+		if (f == field)
+			return name;
+	}
+	return "";
+}
+
+void ModelSaxReader::markField() {
+	Frame &top = stack.back();
+	if (top.field != Field::NONE)
+		top.seen |= 1u << unsigned(top.field);
+}
+
+void ModelSaxReader::checkFields(const Frame &frame) const {
+	static const Field stateFields[] = {
+		Field::TIME, Field::WORLD_ORIGIN, Field::WORLD_END, Field::ROBOTS,
+		Field::PARTICLES};
+	static const Field robotFields[] = {
+		Field::ID, Field::POSITION, Field::RADIUS, Field::ANGLE,
+		Field::CAPTURE_ANGLE, Field::LEFT_SPEED, Field::RIGHT_SPEED, Field::SCORE};
+	static const Field particleFields[] = {
+		Field::ID, Field::POSITION, Field::RADIUS, Field::EXPLOSION_TIMES};
+	static const Field positionFields[] = {Field::X, Field::Y};
+
+	std::span<const Field> required;
+	const char *object = "";
+	switch (frame.context) {
+		case Context::ROOT:
+			if (timeline)
+				return;
+			// Neither a timeline nor a state, a constraints file for instance
+			if (!(frame.seen & (1u << unsigned(Field::ROBOTS) |
+									  1u << unsigned(Field::PARTICLES))))
+				throw std::runtime_error("The file has no states, robots or "
+												 "particles");
+			[[fallthrough]];
+		case Context::STATE:
+			required = stateFields;
+			object = "state";
+			break;
+		case Context::ROBOT:
+			required = robotFields;
+			object = "robot";
+			break;
+		case Context::PARTICLE:
+			required = particleFields;
+			object = "particle";
+			break;
+		case Context::POSITION:
+			required = positionFields;
+			object = "position";
+			break;
+		default:
+			return;
+	}
+	for (Field field: required) {
+		if (!(frame.seen & (1u << unsigned(field))))
+			throw std::runtime_error(std::string("Missing field '") + fieldName(field)
+											 + "' in a " + object);
+	}
+}
+
+bool ModelSaxReader::start_object(std::size_t) {
+	if (stack.empty()) {
+		stack.push_back({Context::ROOT});
+		state = StateFields();
+		return true;
+	}
+
+	Frame &top = stack.back();
+	switch (top.context) {
+		case Context::STATES:
+			state = StateFields();
+			stack.push_back({Context::STATE});
+			return true;
+		case Context::ROBOTS:
+			robot = RobotFields();
+			stack.push_back({Context::ROBOT});
+			return true;
+		case Context::PARTICLES:
+			particle = ParticleFields();
+			stack.push_back({Context::PARTICLE});
+			return true;
+		default:
+			break;
+	}
+
+	// Objects nested in a field
+	markField();
+	position = nullptr;
+	if (top.context == Context::ROOT || top.context == Context::STATE) {
+		if (top.field == Field::WORLD_ORIGIN)
+			position = &state.worldOrigin;
+		else if (top.field == Field::WORLD_END)
+			position = &state.worldEnd;
+	} else if (top.field == Field::POSITION) {
+		if (top.context == Context::ROBOT)
+			position = &robot.position;
+		else if (top.context == Context::PARTICLE)
+			position = &particle.position;
+	}
+	stack.push_back({position != nullptr ? Context::POSITION : Context::SKIP});
+	return true;
+}
+
+bool ModelSaxReader::key(string_t &val) {
+	Frame &top = stack.back();
+	if (top.context != Context::SKIP)
+		top.field = toField(val);
+	return true;
+}
+
+bool ModelSaxReader::start_array(std::size_t) {
+	Context context = Context::SKIP;
+	if (!stack.empty()) {
+		markField();
+		const Frame &top = stack.back();
+		switch (top.context) {
+			case Context::ROOT:
+				if (top.field == Field::STATES) {
+					timeline = true;
+					context = Context::STATES;
+					break;
+				}
+				[[fallthrough]];
+			case Context::STATE:
+				if (top.field == Field::ROBOTS)
+					context = Context::ROBOTS;
+				else if (top.field == Field::PARTICLES)
+					context = Context::PARTICLES;
+				break;
+			case Context::PARTICLE:
+				if (top.field == Field::EXPLOSION_TIMES)
+					context = Context::EXPLOSION_TIMES;
+				break;
+			case Context::EXPLOSION_TIMES:
+				particle.explosionTimes.emplace_back();
+				context = Context::GENERATION;
+				break;
+			default:
+				break;
+		}
+	}
+	stack.push_back({context});
+	return true;
+}
+
+bool ModelSaxReader::number(double val) {
+	if (stack.empty())
+		return true;
+
+	markField();
+	const Frame &top = stack.back();
+	switch (top.context) {
+		case Context::ROOT:
+		case Context::STATE:
+			if (top.field == Field::TIME)
+				state.time = val;
+			break;
+		case Context::ROBOT:
+			switch (top.field) {
+				case Field::ID: robot.id = int(val); break;
+				case Field::RADIUS: robot.radius = val; break;
+				case Field::ANGLE: robot.angle = val; break;
+				case Field::CAPTURE_ANGLE: robot.captureAngle = val; break;
+				case Field::LEFT_SPEED: robot.leftSpeed = val; break;
+				case Field::RIGHT_SPEED: robot.rightSpeed = val; break;
+				case Field::SCORE: robot.score = val; break;
+				default: break;
+			}
+			break;
+		case Context::PARTICLE:
+			if (top.field == Field::ID)
+				particle.id = int(val);
+			else if (top.field == Field::RADIUS)
+				particle.radius = val;
+			break;
+		case Context::POSITION:
+			if (top.field == Field::X)
+				position->setX(val);
+			else if (top.field == Field::Y)
+				position->setY(val);
+			break;
+		case Context::GENERATION:
+			particle.explosionTimes.back().push_back(val);
+			break;
+		default:
+			break;
+	}
+	return true;
+}
+
+bool ModelSaxReader::end_object() {
+	checkFields(stack.back());
+	Context context = stack.back().context;
+	stack.pop_back();
+	switch (context) {
+		case Context::ROBOT: {
+			// The files give the angles in degrees
+			Robot r(robot.id, robot.position, robot.radius, 0.0, 0.0,
+					  robot.leftSpeed, robot.rightSpeed);
+			r.setFileAngles(robot.angle, robot.captureAngle);
+			r.setScore(robot.score);
+			state.robots.push_back(r);
+			break;
+		}
+		case Context::PARTICLE:
+			state.particles.emplace_back(particle.id, particle.position,
+												  particle.radius,
+												  std::move(particle.explosionTimes));
+			break;
+		case Context::STATE:
+			emitState();
+			break;
+		case Context::ROOT:
+			// A state file is a single state at the root
+			if (!timeline)
+				emitState();
+			break;
+		default:
+			break;
+	}
+	return true;
+}
+
+bool ModelSaxReader::end_array() {
+	stack.pop_back();
+	return true;
+}
+
+void ModelSaxReader::emitState() {
+	onState(State(state.time, state.worldOrigin, state.worldEnd,
+					  std::move(state.robots), std::move(state.particles)));
+	state = StateFields();
+}
+
+bool ModelSaxReader::parse_error(std::size_t, const std::string &,
+											const nlohmann::detail::exception &ex) {
+	throw std::runtime_error(ex.what());
+}
+
+void readStates(std::istream &input, const StateCallback &onState) {
+	if (BlockReader::isBlockFile(input)) {
+		BlockReader(input).readAll(onState);
+		return;
+	}
+
+	ModelSaxReader reader(onState);
+	FileFormat format = detectFormat(input);
+	nlohmann::json::sax_parse(input, &reader, toInputFormat(format));
+}
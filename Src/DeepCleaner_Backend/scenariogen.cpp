@@ -0,0 +1,221 @@
+/*-----------------------------------------------------------------------------
+File name : scenariogen.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Program that generates a base state and its constraints from a
+ seed, to run the Backend and the UI on large worlds. The same seed and
+ arguments give the same files on every platform.
+
+Command line arguments: DeepCleaner_Gen <Output name> [-s <Seed>]
+ [-r <Robots>] [-p <Particles>] [-w <Width[:Height]>] [-d <Radius distribution>]
+ [-m <Min:Max radius>] [-b <Robot radius>] [-a <Capture angle>] [-g <Gap>]
+ [-e <Explosion depth>] [-t <First:Last explosion>] [-x <Time distribution>]
+ [-c <Min:Max child delay>] [-i <Command interval>] [-v <Backward:Forward>]
+ [-f <Format>]
+Writes <Output name>.stat and <Output name>.constraints
+Exit code: 0 if the files are written, 1 on error
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "fileformat.h"
+#include "generator.h"
+#include "utils.h"
+
+using namespace std;
+const int GENERATED = 0, GENERATION_ERROR = 1;
+const string CONSTRAINT_EXT = ".constraints", STATE_EXT = ".stat";
+
+void showHelp();
+
+// "low:high", or a single value for both when single is allowed
+void parseRange(const string &text, double &low, double &high, bool single);
+
+double parseNumber(const string &text);
+
+void applyArgument(char name, const string &value, ScenarioParameters &parameters,
+                   FileFormat &format);
+
+int main(int argc, char *argv[]) {
+    ScenarioParameters parameters;
+    FileFormat format = JSON_PRETTY;
+    string output;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc) {
+                applyArgument(arg[1], argv[++i], parameters, format);
+            } else if (arg.size() > 1 && arg[0] == '-') {
+                showHelp();
+                return GENERATION_ERROR;
+            } else if (output.empty()) {
+                output = arg;
+            } else {
+                showHelp();
+                return GENERATION_ERROR;
+            }
+        }
+    }
+    catch (exception &e) {
+        cerr << e.what() << '\n';
+        showHelp();
+        return GENERATION_ERROR;
+    }
+    if (output.empty()) {
+        showHelp();
+        return GENERATION_ERROR;
+    }
+
+    try {
+        auto start = chrono::steady_clock::now();
+        Scenario scenario = generateScenario(parameters);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        string statePath = addExtension(output, STATE_EXT);
+        string constraintsPath = addExtension(output, CONSTRAINT_EXT);
+        scenario.state.serialize(statePath, format);
+        ofstream constraintsFile(constraintsPath);
+        if (!constraintsFile)
+            throw runtime_error("Could not create '" + constraintsPath + "'");
+        constraintsFile << setw(4) << json(scenario.constraints) << '\n';
+
+        const State &state = scenario.state;
+        cout << state.getRobots().size() << " robots and "
+             << state.getParticles().size() << " particles in a "
+             << state.getWorldEnd().getX() - state.getWorldOrigin().getX() << " x "
+             << state.getWorldEnd().getY() - state.getWorldOrigin().getY()
+             << " world, placed in " << elapsed.count() << " sec\n"
+             << "Written to " << statePath << " and " << constraintsPath << '\n';
+        return GENERATED;
+    }
+    catch (exception &e) {
+        cerr << "Exception occurred : " << e.what() << '\n';
+        return GENERATION_ERROR;
+    }
+}
+
+void parseRange(const string &text, double &low, double &high, bool single) {
+    size_t separator = text.find(':');
+    if (separator == string::npos && !single)
+        throw invalid_argument("Expected a range 'min:max', got '" + text + "'");
+    try {
+        low = stod(text.substr(0, separator));
+        high = separator == string::npos ? low : stod(text.substr(separator + 1));
+    }
+    catch (exception &) {
+        throw invalid_argument("Invalid number in '" + text + "'");
+    }
+}
+
+double parseNumber(const string &text) {
+    double low, high;
+    parseRange(text, low, high, true);
+    if (text.find(':') != string::npos)
+        throw invalid_argument("Expected a single number, got '" + text + "'");
+    return low;
+}
+
+void applyArgument(char name, const string &value, ScenarioParameters &parameters,
+                   FileFormat &format) {
+    ScenarioParameters &p = parameters;
+    switch (name) {
+        case 's':
+            try {
+                p.seed = stoull(value);
+            }
+            catch (exception &) {
+                throw invalid_argument("Invalid seed '" + value + "'");
+            }
+            break;
+        case 'r':
+            p.robotCount = int(parseNumber(value));
+            break;
+        case 'p':
+            p.particleCount = int(parseNumber(value));
+            break;
+        case 'w':
+            parseRange(value, p.worldWidth, p.worldHeight, true);
+            break;
+        case 'd':
+            if (!parseRadiusDistribution(value, p.radiusDistribution))
+                throw invalid_argument("Unknown radius distribution '" + value + "'");
+            break;
+        case 'm':
+            parseRange(value, p.minRadius, p.maxRadius, true);
+            break;
+        case 'b':
+            p.robotRadius = parseNumber(value);
+            break;
+        case 'a':
+            p.captureAngle = parseNumber(value);
+            break;
+        case 'g':
+            p.spacing = parseNumber(value);
+            break;
+        case 'e':
+            p.explosionDepth = int(parseNumber(value));
+            break;
+        case 't':
+            parseRange(value, p.firstExplosion, p.lastExplosion, true);
+            break;
+        case 'x':
+            if (!parseTimeDistribution(value, p.timeDistribution))
+                throw invalid_argument("Unknown time distribution '" + value + "'");
+            break;
+        case 'c':
+            parseRange(value, p.minChildDelay, p.maxChildDelay, true);
+            break;
+        case 'i':
+            p.constraints.commandTimeInterval = parseNumber(value);
+            break;
+        case 'v':
+            parseRange(value, p.constraints.maxBackwardSpeed,
+                       p.constraints.maxForwardSpeed, false);
+            break;
+        case 'f':
+            if (!parseFormatName(value, format))
+                throw invalid_argument("Unknown format '" + value + "'");
+            break;
+        default:
+            throw invalid_argument(string("Unknown argument -") + name);
+    }
+}
+
+void showHelp() {
+    ScenarioParameters d;
+    cout << "Usage : DeepCleaner_Gen <Output name> [options]\n"
+         << "Writes a base state <Output name>" << STATE_EXT << " and its constraints "
+         << "<Output name>" << CONSTRAINT_EXT << ", the same for the same seed\n"
+         << " -s <Seed> (default " << d.seed << ")\n"
+         << " -r <Robots> (default " << d.robotCount << ")\n"
+         << " -p <Particles> (default " << d.particleCount << ")\n"
+         << " -w <World size : width[:height]>, sized for "
+         << DEFAULT_WORLD_FILL * 100 << "% of bodies by default\n"
+         << " -d <Radius distribution : uniform, normal, loguniform> (default "
+         << radiusDistributionName(d.radiusDistribution) << ")\n"
+         << " -m <Particle radii : min:max> (default " << d.minRadius << ':'
+         << d.maxRadius << ")\n"
+         << " -b <Robot radius> (default " << d.robotRadius << ")\n"
+         << " -a <Capture angle of the robots, deg> (default " << d.captureAngle
+         << ")\n"
+         << " -g <Smallest gap between two bodies> (default " << d.spacing << ")\n"
+         << " -e <Explosion tree depth, 0 to " << MAX_EXPLOSION_DEPTH << "> (default "
+         << d.explosionDepth << ")\n"
+         << " -t <First explosions : first:last, sec> (default " << d.firstExplosion
+         << ':' << d.lastExplosion << ")\n"
+         << " -x <Time distribution : uniform, exponential> (default "
+         << timeDistributionName(d.timeDistribution) << ")\n"
+         << " -c <Children explosions after their parent : min:max, sec> (default "
+         << d.minChildDelay << ':' << d.maxChildDelay << ")\n"
+         << " -i <Command time interval, sec> (default "
+         << d.constraints.commandTimeInterval << ")\n"
+         << " -v <Speeds : maxBackward:maxForward> (default "
+         << d.constraints.maxBackwardSpeed << ':' << d.constraints.maxForwardSpeed
+         << ")\n"
+         << " -f <State format : json, compact, cbor, msgpack, bson> (default json)\n";
+}
@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------------
+File name : simconfig.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Parameters of the simulation engine. The engine is a template on
+a configuration type : DefaultSimConfig gives the values as constants, folded
+in the step by the compiler, and RuntimeSimConfig holds the same values as
+fields, for a frame rate only known when the program starts. ExactSimConfig
+runs the engine in exact mode, on integer frames and fixed-point positions
+(fixedpoint.h).
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef SIMCONFIG_H
+#define SIMCONFIG_H
+
+#include <concepts>
+
+struct DefaultSimConfig {
+	static constexpr int framePerSec = 24;
+	static constexpr double timePerFrame = 1.0 / framePerSec;      // sec
+	static constexpr double collisionEpsilon = 2.0;   // pixels, margin of a contact
+	static constexpr double angleTolerance = 0.005;   // rad, robot facing its target
+	static constexpr double explosionTolerance = 0.0001; // sec
+	static constexpr bool exact = false; // integer frames, fixed-point positions
+};
+
+struct ExactSimConfig : DefaultSimConfig {
+	static constexpr bool exact = true;
+};
+
+struct RuntimeSimConfig {
+	int framePerSec;
+	double timePerFrame;
+	double collisionEpsilon = DefaultSimConfig::collisionEpsilon;
+	double angleTolerance = DefaultSimConfig::angleTolerance;
+	double explosionTolerance = DefaultSimConfig::explosionTolerance;
+	bool exact;
+
+	explicit RuntimeSimConfig(int framePerSec = DefaultSimConfig::framePerSec,
+									  bool exact = false)
+		: framePerSec(framePerSec), timePerFrame(1.0 / framePerSec), exact(exact) {}
+};
+
+// Read the same way on both types, config.timePerFrame
+template <typename T>
+concept SimConfig = requires(const T &config) {
+	{ config.framePerSec } -> std::convertible_to<int>;
+	{ config.timePerFrame } -> std::convertible_to<double>;
+	{ config.collisionEpsilon } -> std::convertible_to<double>;
+	{ config.angleTolerance } -> std::convertible_to<double>;
+	{ config.explosionTolerance } -> std::convertible_to<double>;
+	{ config.exact } -> std::convertible_to<bool>;
+};
+
+// Margin at which the simulation considers that two objects touch
+const double COLLISION_EPSILON = DefaultSimConfig::collisionEpsilon;
+
+#endif // SIMCONFIG_H
@@ -0,0 +1,1484 @@
+/*-----------------------------------------------------------------------------
+File name : simulation.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the simulation engine, moved out of the main
+loop of the Backend
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "simulation.h"
+#include "taskpool.h"
+#include "fileformat.h"
+#include "fixedpoint.h"
+#include "kinematics.h"
+#include "trajectory.h"
+#include "utils.h"
+
+using namespace std;
+const double SQRT2 = sqrt(2.0);
+const int CHECKPOINT_VERSION = 2;
+const int FIRST_JOURNAL_VERSION = 2;
+const string JOURNAL_EXT = ".states";
+const double COMMAND_TIME_TOLERANCE = 1e-6; // sec, drift of the summed frames
+const double STATE_TOLERANCE = 1e-9; // pixels, degrees and score of a state read again
+
+map<int, Movement> initRobots(vector<Robot> &robots, MovementType status);
+
+// Fields of a movement in the checkpoint and in the journal
+json movementToJson(const Movement &m);
+
+Movement movementFromJson(const json &m);
+
+json engineToJson(const EngineRecord &record);
+
+EngineRecord engineFromJson(const json &engine);
+
+// One CBOR record per state, with the robot angles in radians. The last states
+// also have the engine data of records. The positions of the records are added
+// to offsets, the first one is written at position. Return the end position
+uint64_t appendStates(ostream &os, span<const State> states,
+                      span<const EngineRecord> records, vector<uint64_t> &offsets,
+                      uint64_t position);
+
+State readState(const json &record);
+
+void assignAllNearestParticle(vector<Robot> &robots, const CostMatrix &costs);
+
+void assignNearestParticle(Robot &robot, size_t row, const CostMatrix &costs,
+                           int excludedId = -1);
+
+template <SimConfig Config>
+Movement initRotation(Robot &r, Position pPos, Constraints con, const Config &config);
+
+template <SimConfig Config>
+Movement initLineMovement(Robot &r, Position pPos, Constraints con, double pRadius,
+                          const Config &config);
+
+template <SimConfig Config>
+Movement initArcMovement(const ArcPlan &plan, Constraints con, const Config &config);
+
+template <SimConfig Config>
+double syncTime(double time, const Constraints &con, const Config &config);
+
+template <SimConfig Config>
+Movement planMovement(Robot &r, const Particle &p, const Constraints &con,
+                      const Config &config, MoveMode moveMode);
+
+// The rotation was planned toward another particle or turns the long way
+bool isRotationStale(const Robot &r, const Movement &movement, const Particle &p,
+                     double targetAngle);
+
+bool isOffCourse(const Robot &r, const Particle &p);
+
+Movement initIdleMovement();
+
+Movement movementFromSpeeds(const Robot &r);
+
+bool hasExploded(const Particle &p, double currentTime, double tolerance);
+
+bool hasExplodedAt(const Particle &p, int64_t frame, int framePerSec,
+                   double tolerance);
+
+template <SimConfig Config>
+void manageParticleExplosion(double timer, int64_t frame, bool &explosionHappened,
+                             vector<Particle> &particles, const Config &config,
+                             pmr::memory_resource *arena);
+
+bool touches(const Position &p1, double radius1, const Position &p2,
+             double radius2, double epsilon, bool exact);
+
+Particle *particleCollision(const Robot &r1, vector<Particle> &particles,
+                           double epsilon, bool exact);
+
+// Facing the particle within the capture angle, c.f. décontamination
+bool inCaptureAngle(const Robot &r, const Particle &p, double angleTolerance);
+
+// Touching particle in the capture angle, the first one if several
+template <SimConfig Config>
+Particle *capturedParticle(const Robot &r, vector<Particle> &particles,
+                           const Config &config);
+
+bool robotCollision(const Robot &r1, const vector<Robot> &robs, double epsilon,
+                    bool exact);
+
+void snapToGrid(vector<Robot> &robots, vector<Particle> &particles);
+
+// Null when no particle has the id
+Particle *findParticle(vector<Particle> &particles, int id);
+
+// Null when the robot has no target or its particle is gone
+Particle *findTargetParticle(const Robot &r, vector<Particle> &particles);
+
+// Same bodies at the same time, up to the precision of the files
+bool sameState(const State &a, const State &b, double timeTolerance);
+
+template <SimConfig Config>
+BasicSimulation<Config>::BasicSimulation(const State &initialState,
+                                         const Constraints &constraints,
+                                         StartMode mode, const Config &config)
+        : config(config), constraints(constraints) {
+    timeline.addAndSetState(initialState);
+
+    // Working copies, the initial state stays untouched in the timeline
+    const RobotList &initialRobots = initialState.getRobots();
+    const ParticleList &initialParticles = initialState.getParticles();
+    robots.assign(initialRobots.begin(), initialRobots.end());
+    particles.assign(initialParticles.begin(), initialParticles.end());
+    worldOrigin = initialState.getWorldOrigin();
+    worldEnd = initialState.getWorldEnd();
+
+    if (config.exact)
+        snapToGrid(robots, particles);
+
+    movementMap = initRobots(robots, IDLE);
+    if (mode == TIMELINE_STATE) {
+        // The given state was created at the end of its frame
+        frame = timeToFrame(initialState.getTime(), config.framePerSec) + 1;
+        if (config.exact)
+            timer = frameToTime(frame, config.framePerSec);
+        else
+            timer = initialState.getTime() + config.timePerFrame;
+        for (const Robot &r: robots)
+            movementMap[r.getId()] = movementFromSpeeds(r);
+    }
+    assignTargets();
+}
+
+template <SimConfig Config>
+json BasicSimulation<Config>::readCheckpoint(const std::string &checkpointPath) {
+    std::ifstream f(checkpointPath, std::ios::binary);
+    if (!f)
+        throw std::runtime_error("Could not open the checkpoint '" + checkpointPath
+                                 + "'");
+    json data = json::from_cbor(f);
+    int version = data.at("version").get<int>();
+    if (version < 1 || version > CHECKPOINT_VERSION)
+        throw std::runtime_error("Unsupported checkpoint version");
+
+    // Older checkpoints : default frame rate, float time
+    int framePerSec = data.value("framePerSec", DefaultSimConfig::framePerSec);
+    bool exact = data.value("exact", false);
+    if (framePerSec != this->config.framePerSec || exact != this->config.exact) {
+        if constexpr (std::is_same_v<Config, RuntimeSimConfig>)
+            this->config = RuntimeSimConfig(framePerSec, exact);
+        else
+            throw std::runtime_error("The checkpoint was simulated at "
+                                     + std::to_string(framePerSec)
+                                     + " frames per second"
+                                     + (exact ? " in exact mode" : ""));
+    }
+
+    setStepMode(data.value("stepMode", LEGACY_STEP));
+    setMoveMode(data.value("moveMode", TURN_AND_GO));
+    targetMode = data.value("targetMode", NEAREST_TARGET);
+    recordEngine = data.value("recordEngine", false);
+    constraints = data.at("constraints").get<Constraints>();
+    worldOrigin = data.at("worldOrigin").get<Position>();
+    worldEnd = data.at("worldEnd").get<Position>();
+    return data;
+}
+
+template <SimConfig Config>
+BasicSimulation<Config>::BasicSimulation(const std::string &checkpointPath,
+                                         const Config &config) : config(config) {
+    json data = readCheckpoint(checkpointPath);
+    int version = data.at("version").get<int>();
+    timer = data.at("timer").get<double>();
+    frame = data.value("frame", timeToFrame(timer, this->config.framePerSec));
+    robots = data.at("robots").get<vector<Robot>>();
+    particles = data.at("particles").get<vector<Particle>>();
+
+    // The movements and the targets are not part of the robots json, the
+    // angles are also kept in radians, a round trip in degrees is not exact
+    const json &movements = data.at("movements");
+    for (size_t i = 0; i < robots.size(); ++i) {
+        const json &m = movements.at(i);
+        robots[i].setTargetParticleId(m.at("target").get<int>());
+        if (m.contains("angle"))
+            robots[i].setAngle(m.at("angle").get<double>());
+        movementMap[robots[i].getId()] = movementFromJson(m);
+    }
+
+    if (targetMode == ROUTED_TARGETS)
+        routePlanner = data.at("routes").get<RoutePlanner>();
+
+    if (version < FIRST_JOURNAL_VERSION) {
+        const json &states = data.at("states");
+        const json angles = data.value("angles", json::array());
+        for (size_t i = 0; i < states.size(); ++i)
+            timeline.addState(readState({{"state",  states[i]},
+                                         {"angles", i < angles.size() ? angles[i]
+                                                                      : json::array()}}));
+        timeline.setLastState();
+        return;
+    }
+
+    // A save killed after appending its states left them after the ones of
+    // the checkpoint, they are dropped so that the next saves append
+    std::string statesPath = checkpointPath + JOURNAL_EXT;
+    std::ifstream journal(statesPath, std::ios::binary);
+    if (!journal)
+        throw std::runtime_error("Could not open the checkpoint states '" + statesPath
+                                 + "'");
+    size_t count = data.at("stateCount").get<size_t>();
+    for (size_t i = 0; i < count; ++i) {
+        journalOffsets.push_back(uint64_t(journal.tellg()));
+        timeline.addState(readState(json::from_cbor(journal, false)));
+    }
+    timeline.setLastState();
+    journalEnd = uint64_t(journal.tellg());
+    journal.close();
+    if (std::filesystem::file_size(statesPath) != journalEnd)
+        std::filesystem::resize_file(statesPath, journalEnd);
+    journalPath = statesPath;
+    journalStates = count;
+}
+
+template <SimConfig Config>
+BasicSimulation<Config>::BasicSimulation(const std::string &checkpointPath,
+                                         std::size_t stateIndex,
+                                         const Config &config) : config(config) {
+    json data = readCheckpoint(checkpointPath);
+    if (data.at("version").get<int>() < FIRST_JOURNAL_VERSION ||
+        stateIndex >= data.at("stateCount").get<size_t>())
+        throw std::out_of_range("The fork state is not in the checkpoint journal");
+
+    std::string statesPath = checkpointPath + JOURNAL_EXT;
+    std::ifstream journal(statesPath, std::ios::binary);
+    if (!journal)
+        throw std::runtime_error("Could not open the checkpoint states '" + statesPath
+                                 + "'");
+    // Older checkpoints have no offsets, their records are read up to the fork
+    json record;
+    if (data.contains("stateOffsets")) {
+        journal.seekg(std::streamoff(data.at("stateOffsets").at(stateIndex)
+                                             .get<uint64_t>()));
+        record = json::from_cbor(journal, false);
+    } else {
+        for (size_t i = 0; i <= stateIndex; ++i)
+            record = json::from_cbor(journal, false);
+    }
+    timeline.addAndSetState(readState(record));
+    if (!record.contains("engine"))
+        throw std::runtime_error("The checkpoint has no engine data at the fork "
+                                 "state, it was saved without it");
+
+    const State &state = *timeline.getCurrentState();
+    robots.assign(state.getRobots().begin(), state.getRobots().end());
+    particles.assign(state.getParticles().begin(), state.getParticles().end());
+    restoreEngine(engineFromJson(record.at("engine")));
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::saveCheckpoint(const std::string &path) {
+    // The states first, the checkpoint written after them only counts the
+    // ones it needs
+    std::span<const State> states = timeline.getStates();
+    std::string statesPath = path + JOURNAL_EXT;
+    if (statesPath == journalPath) {
+        std::ofstream ofs(statesPath, std::ios::out | std::ios::binary | std::ios::app);
+        if (!ofs)
+            throw std::runtime_error("Error opening the file '" + statesPath + "'");
+        journalEnd = appendStates(ofs, states.subspan(journalStates), engineRecords,
+                                  journalOffsets, journalEnd);
+    } else {
+        std::string tmpPath = statesPath + ".tmp";
+        {
+            std::ofstream ofs(tmpPath, std::ios::out | std::ios::binary);
+            if (!ofs)
+                throw std::runtime_error("Error creating the file '" + tmpPath + "'");
+            journalOffsets.clear();
+            journalEnd = appendStates(ofs, states, engineRecords, journalOffsets, 0);
+        }
+        std::remove(statesPath.c_str());
+        if (std::rename(tmpPath.c_str(), statesPath.c_str()) != 0)
+            throw std::runtime_error("Could not write the checkpoint states '"
+                                     + statesPath + "'");
+        journalPath = statesPath;
+    }
+    journalStates = states.size();
+    engineRecords.clear();
+
+    json data;
+    data["version"] = CHECKPOINT_VERSION;
+    data["framePerSec"] = config.framePerSec;
+    data["exact"] = bool(config.exact);
+    data["frame"] = frame;
+    data["timer"] = timer;
+    data["stepMode"] = stepMode;
+    data["moveMode"] = moveMode;
+    data["targetMode"] = targetMode;
+    data["recordEngine"] = recordEngine;
+    if (targetMode == ROUTED_TARGETS)
+        data["routes"] = routePlanner;
+    data["constraints"] = constraints;
+    data["worldOrigin"] = worldOrigin;
+    data["worldEnd"] = worldEnd;
+    data["robots"] = robots;
+    data["particles"] = particles;
+
+    json &movements = data["movements"] = json::array();
+    for (const Robot &r: robots) {
+        json m = movementToJson(movementMap.at(r.getId()));
+        m["target"] = r.getTargetParticleId();
+        m["angle"] = r.getAngle();
+        movements.push_back(std::move(m));
+    }
+
+    data["stateCount"] = journalStates;
+    data["stateOffsets"] = journalOffsets;
+
+    // Written aside then renamed, a kill while saving keeps the previous one
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream ofs(tmpPath, std::ios::out | std::ios::binary);
+        if (!ofs)
+            throw std::runtime_error("Error creating the file '" + tmpPath + "'");
+        writeDocument(ofs, data, CBOR);
+    }
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("Could not write the checkpoint '" + path + "'");
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::replaceCurrentState(const State &state) {
+    State &current = *timeline.getCurrentState();
+    if (abs(state.getTime() - current.getTime()) > config.timePerFrame / 2)
+        throw invalid_argument("The edited state is not at the time of the state it "
+                               "replaces");
+    current = state;
+
+    vector<Robot> previous = std::move(robots);
+    map<int, Movement> previousMovements = std::move(movementMap);
+    const RobotList &newRobots = state.getRobots();
+    const ParticleList &newParticles = state.getParticles();
+    robots.assign(newRobots.begin(), newRobots.end());
+    particles.assign(newParticles.begin(), newParticles.end());
+    worldOrigin = state.getWorldOrigin();
+    worldEnd = state.getWorldEnd();
+    if (config.exact)
+        snapToGrid(robots, particles);
+
+    movementMap.clear();
+    bool targetLost = false;
+    for (Robot &r: robots) {
+        auto old = find_if(previous.begin(), previous.end(), [&](const Robot &o) {
+            return o.getId() == r.getId();
+        });
+        Movement movement = movementFromSpeeds(r);
+        int target = -1;
+        if (old != previous.end()) {
+            if (old->getLeftSpeed() == r.getLeftSpeed() &&
+                old->getRightSpeed() == r.getRightSpeed())
+                movement = previousMovements.at(r.getId());
+            target = old->getTargetParticleId();
+        }
+        movementMap[r.getId()] = movement;
+        bool kept = any_of(particles.begin(), particles.end(), [&](const Particle &p) {
+            return p.getId() == target;
+        });
+        r.setTargetParticleId(kept ? target : -1);
+        targetLost = targetLost || !kept;
+    }
+
+    if (targetMode == ROUTED_TARGETS) {
+        costMatrix.update(robots, particles, constraints);
+        routePlanner.plan(robots, particles, constraints, timer, costMatrix);
+        assignTargets();
+    } else if (targetLost) {
+        assignTargets();
+    }
+}
+
+template <SimConfig Config>
+std::vector<State> simulateFrom(const State &startState,
+                                const Constraints &constraints,
+                                const Config &config, StepMode stepMode,
+                                MoveMode moveMode, TargetMode targetMode) {
+    BasicSimulation<Config> simulation(startState, constraints, TIMELINE_STATE,
+                                       config);
+    simulation.setStepMode(stepMode);
+    simulation.setMoveMode(moveMode);
+    simulation.setTargetMode(targetMode);
+    while (!simulation.isFinished())
+        simulation.step();
+    span<const State> states = simulation.getTimeline().getStates();
+    return vector<State>(states.begin() + 1, states.end());
+}
+
+template <SimConfig Config>
+std::optional<std::vector<State>> simulateFrom(std::span<const State> source,
+                                               std::size_t index,
+                                               const State *editedState,
+                                               const Constraints &constraints,
+                                               const Config &config,
+                                               StepMode stepMode, MoveMode moveMode,
+                                               TargetMode targetMode) {
+    if (index >= source.size())
+        throw out_of_range("The fork state index is out of the timeline");
+    const State &forkState = source[index];
+
+    // Same start as the run, a first state is simulated from time 0
+    BasicSimulation<Config> simulation(source.front(), constraints, BASE_STATE,
+                                       config);
+    simulation.setStepMode(stepMode);
+    simulation.setMoveMode(moveMode);
+    simulation.setTargetMode(targetMode);
+    // A compacted timeline holds a part of the states simulated
+    double forkTime = forkState.getTime() - config.timePerFrame / 2;
+    while (!simulation.isFinished() &&
+           simulation.getTimeline().getCurrentState()->getTime() < forkTime)
+        simulation.step();
+    if (!sameState(*simulation.getTimeline().getCurrentState(), forkState,
+                   config.timePerFrame / 2))
+        return nullopt;
+
+    if (editedState != nullptr)
+        simulation.replaceCurrentState(*editedState);
+    size_t first = simulation.getTimeline().getStates().size();
+    while (!simulation.isFinished())
+        simulation.step();
+    span<const State> states = simulation.getTimeline().getStates();
+    return vector<State>(states.begin() + long(first), states.end());
+}
+
+template <SimConfig Config>
+std::vector<State> simulateFrom(const std::string &checkpointPath, std::size_t index,
+                                const State *editedState, const Config &config) {
+    BasicSimulation<Config> simulation(checkpointPath, index, config);
+    if (editedState != nullptr)
+        simulation.replaceCurrentState(*editedState);
+    size_t first = simulation.getTimeline().getStates().size();
+    while (!simulation.isFinished())
+        simulation.step();
+    span<const State> states = simulation.getTimeline().getStates();
+    return vector<State>(states.begin() + long(first), states.end());
+}
+
+Timeline loadCheckpointStates(const std::string &checkpointPath) {
+    std::ifstream f(checkpointPath, std::ios::binary);
+    if (!f)
+        throw std::runtime_error("Could not open the checkpoint '" + checkpointPath
+                                 + "'");
+    json data = json::from_cbor(f);
+    if (data.at("version").get<int>() < FIRST_JOURNAL_VERSION)
+        throw std::runtime_error("The checkpoint has no states journal");
+
+    std::string statesPath = checkpointPath + JOURNAL_EXT;
+    std::ifstream journal(statesPath, std::ios::binary);
+    if (!journal)
+        throw std::runtime_error("Could not open the checkpoint states '" + statesPath
+                                 + "'");
+    Timeline timeline;
+    size_t count = data.at("stateCount").get<size_t>();
+    for (size_t i = 0; i < count; ++i)
+        timeline.addState(readState(json::from_cbor(journal, false)));
+    timeline.setFirstState();
+    return timeline;
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::setTargetMode(TargetMode mode) {
+    if (mode == targetMode)
+        return;
+    targetMode = mode;
+    if (mode == ROUTED_TARGETS) {
+        costMatrix.update(robots, particles, constraints);
+        routePlanner.plan(robots, particles, constraints, timer, costMatrix);
+    }
+    assignTargets();
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::assignTargets() {
+    // Only the robots that moved and the new particles are computed again
+    costMatrix.update(robots, particles, constraints);
+    if (targetMode == NEAREST_TARGET) {
+        assignAllNearestParticle(robots, costMatrix);
+    } else {
+        routePlanner.update(robots, particles, constraints, timer, costMatrix);
+        for (size_t i = 0; i < robots.size(); ++i) {
+            Robot &r = robots[i];
+            r.setTargetParticleId(routePlanner.getTarget(r.getId()));
+            // More robots than particles, the others go to their nearest one
+            if (r.getTargetParticleId() == -1)
+                assignNearestParticle(r, i, costMatrix);
+        }
+    }
+
+    // A robot stopped against a particle turns to decontaminate it first
+    for (Robot &r: robots) {
+        const Movement &m = movementMap[r.getId()];
+        if (m.capture && any_of(particles.begin(), particles.end(),
+                                [&](const Particle &p) { return p.getId() == m.targetId; }))
+            r.setTargetParticleId(m.targetId);
+    }
+}
+
+template <SimConfig Config>
+Movement BasicSimulation<Config>::planCapture(Robot &r, const Particle &p) {
+    r.setTargetParticleId(p.getId());
+    Movement movement = planMovement(r, p, constraints, config, TURN_AND_GO);
+    movement.capture = true;
+    movementMap[r.getId()] = movement;
+    return movement;
+}
+
+template <SimConfig Config>
+bool BasicSimulation<Config>::isFinished() const {
+    return timeline.getCurrentState()->getParticles().empty();
+}
+
+template <SimConfig Config>
+bool BasicSimulation<Config>::step() {
+    bool stateAdded = stepMode == TWO_PHASE_STEP ? stepTwoPhase() : stepLegacy();
+    // Taken after the frame, the next one starts with it
+    if (stateAdded && recordEngine)
+        engineRecords.push_back(currentEngine());
+    return stateAdded;
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::setRecordEngine(bool record) {
+    if (record == recordEngine)
+        return;
+    recordEngine = record;
+    engineRecords.clear();
+    // The states already in the journal keep the data they were saved with
+    if (record && timeline.getStates().size() > journalStates)
+        engineRecords.push_back(currentEngine());
+}
+
+template <SimConfig Config>
+EngineRecord BasicSimulation<Config>::currentEngine() const {
+    EngineRecord record{frame, timer, {}, {}, nullopt};
+    record.targets.reserve(robots.size());
+    record.movements.reserve(robots.size());
+    for (const Robot &r: robots) {
+        record.targets.push_back(r.getTargetParticleId());
+        record.movements.push_back(movementMap.at(r.getId()));
+    }
+    if (targetMode == ROUTED_TARGETS)
+        record.routes = routePlanner;
+    return record;
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::restoreEngine(const EngineRecord &record) {
+    if (record.targets.size() != robots.size() ||
+        record.movements.size() != robots.size())
+        throw std::runtime_error("The engine data does not match the robots of the "
+                                 "state");
+    if (targetMode == ROUTED_TARGETS && !record.routes)
+        throw std::runtime_error("The engine data has no routes");
+    frame = record.frame;
+    timer = record.timer;
+    movementMap.clear();
+    for (size_t i = 0; i < robots.size(); ++i) {
+        robots[i].setTargetParticleId(record.targets[i]);
+        movementMap[robots[i].getId()] = record.movements[i];
+    }
+    if (targetMode == ROUTED_TARGETS)
+        routePlanner = *record.routes;
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::addCurrentState() {
+    // The exact mode snaps the angles read again back to its grid
+    if (!config.exact) {
+        for (Robot &r: robots)
+            r.roundToFileAngles();
+    }
+    timeline.addAndSetState(State(timer, worldOrigin, worldEnd, robots, particles));
+}
+
+template <SimConfig Config>
+bool BasicSimulation<Config>::stepLegacy() {
+    // Flags for state creation
+    bool particleExploded = false;
+    bool commandSent = false;
+    bool particleEaten = false;
+    bool hasCollided = false;
+
+    bool hasCollidedWithParticle;
+    bool hasCollidedWithRobot;
+    double targetAngle;
+
+    stepArena.release();
+
+    //For each particle Manage check if it will explode
+    manageParticleExplosion(timer, frame, particleExploded, particles, config,
+                            &stepArena);
+    if (particleExploded)
+        assignTargets();
+
+    for (Robot &r: robots) {
+        hasCollidedWithParticle = false;
+        hasCollidedWithRobot = false;
+        Particle *blocking = nullptr;
+        //Find the particle linked to the current robot
+        Particle *p = findTargetParticle(r, particles);
+
+        //Get the actual movement status of the robot
+        Movement movement = {movementMap[r.getId()]};
+
+
+        //Special condition for collision management.
+        if (movement.movementType != IDLE) {
+            //Store object that collides with our robot, turning on itself it
+            //pushes none
+            bool robotCollider = movement.movementType != ROTATION &&
+                                 robotCollision(r, robots, config.collisionEpsilon,
+                                                config.exact);
+            Particle *particleCollider = capturedParticle(r, particles, config);
+            // Out of the capture angle, a moving robot stops against the
+            // particle, turning on itself does not push it
+            if (particleCollider == nullptr && movement.movementType != ROTATION)
+                blocking = particleCollision(r, particles, config.collisionEpsilon,
+                                             config.exact);
+
+            // Stopped, the speeds of the file are those of the idle movement
+            if (robotCollider || particleCollider != nullptr || blocking != nullptr) {
+                movementMap[r.getId()] = initIdleMovement();
+                r.setSpeed(0, 0);
+                hasCollided = true;
+            }
+            if (robotCollider) {
+                //se stop
+                hasCollidedWithRobot = true;
+            }
+            if (particleCollider != nullptr) {
+                // Read before the erase, which moves the particles
+                int eatenId = particleCollider->getId();
+                r.setScore(r.getScore() + getArea(particleCollider->getRadius()));
+                particles.erase(remove_if(particles.begin(), particles.end(),
+                                          [=](const Particle &p) {
+                                              return p.getId() == eatenId;
+                                          }));
+                particleEaten = true;
+                hasCollidedWithParticle = true;
+            }
+        }
+        movement = {movementMap[r.getId()]};
+        if (movement.movementType == IDLE) {
+
+            //If the robot collided with particle or if it hasn't collided at all
+            // starting point of our moving algorithm
+            if (blocking != nullptr && !hasCollidedWithRobot) {
+                movement = planCapture(r, *blocking);
+                r.setSpeed(movement.lSpeed, movement.rSpeed);
+                commandSent = true;
+            } else if (hasCollidedWithParticle || (!hasCollidedWithParticle &&
+                                                   !hasCollidedWithRobot)) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+
+                //Set the new movement the robot is doing, without a particle
+                //left for it the robot waits
+                if (p != nullptr) {
+                    movement = planMovement(r, *p, constraints, config, moveMode);
+                    movementMap[r.getId()] = {movement};
+                    r.setSpeed(movement.lSpeed, movement.rSpeed);
+                    commandSent = true;
+                }
+            }
+
+        } else if (movement.movementType == ROTATION) {
+            if (particleEaten || particleExploded) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+            }
+            // Aligned early or given a new target, the robot keeps turning up
+            // to a command frame, where the rotation is planned again if needed.
+            // Without a particle left for it, it keeps turning
+            if (p != nullptr)
+                targetAngle = getAngle(r.getPosition(), p->getPosition());
+            if (p == nullptr || !isCommandFrame()) {
+                double newAngle = updateAngle(r.getAngle(), r.getRadius(), r
+                        .getLeftSpeed(), r.getRightSpeed(), config.timePerFrame);
+                r.setAngle(config.exact ? snapFine(newAngle) : newAngle);
+            } else if (!equal(targetAngle, r.getAngle(), config.angleTolerance)) {
+                if (isRotationStale(r, movement, *p, targetAngle)) {
+                    movement = planMovement(r, *p, constraints, config, TURN_AND_GO);
+                    r.setSpeed(movement.lSpeed, movement.rSpeed);
+                    movementMap[r.getId()] = {movement};
+                    commandSent = true;
+                } else {
+                    double newAngle = updateAngle(r.getAngle(), r.getRadius(), r
+                            .getLeftSpeed(), r.getRightSpeed(), config.timePerFrame);
+                    r.setAngle(config.exact ? snapFine(newAngle) : newAngle);
+                }
+            } else {
+                movement = initLineMovement(r, p->getPosition(),
+                                            constraints, p->getRadius(), config);
+                r.setSpeed(movement.lSpeed, movement.rSpeed);
+                movementMap[r.getId()] = {movement};
+                commandSent = true;
+            }
+        } else if (movement.movementType == LINE) {
+            if (particleEaten || particleExploded) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+            }
+            Position newPos = updateCoordinate(r.getPosition(),
+                                               r.getRightSpeed(),
+                                               r.getAngle(),
+                                               config.timePerFrame);
+            r.setPosition(config.exact ? snapToGrid(newPos) : newPos);
+        } else if (movement.movementType == ARC) {
+            if (particleEaten || particleExploded) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+            }
+            // The target changed or the arc drifted away from it
+            if (p != nullptr && isCommandFrame() && isOffCourse(r, *p)) {
+                movement = planMovement(r, *p, constraints, config, moveMode);
+                movementMap[r.getId()] = movement;
+                r.setSpeed(movement.lSpeed, movement.rSpeed);
+                commandSent = true;
+            } else {
+                Pose pose = advancePose({r.getPosition(), r.getAngle()},
+                                        r.getRadius(), r.getLeftSpeed(),
+                                        r.getRightSpeed(), config.timePerFrame);
+                r.setPosition(config.exact ? snapToGrid(pose.position)
+                                           : pose.position);
+                r.setAngle(config.exact ? snapFine(pose.angle) : pose.angle);
+            }
+        }
+
+    }
+
+    bool stateAdded = particleExploded || commandSent || particleEaten || hasCollided;
+    if (stateAdded)
+        addCurrentState();
+    nextFrame();
+    return stateAdded;
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::proposeMovement(std::size_t index) {
+    // Only reads the robots and the particles, the commit writes them
+    const Robot &r = robots[index];
+    Proposal &proposal = proposals[index];
+    proposal = Proposal();
+    MovementType type = movementMap.at(r.getId()).movementType;
+    if (type == IDLE)
+        return;
+
+    for (const Particle &p: particles) {
+        if (!touches(r.getPosition(), r.getRadius(), p.getPosition(), p.getRadius(),
+                     config.collisionEpsilon, config.exact))
+            continue;
+        if (inCaptureAngle(r, p, config.angleTolerance)) {
+            proposal.particleId = p.getId();
+            break;
+        }
+        if (proposal.blockingId == -1 && type != ROTATION)
+            proposal.blockingId = p.getId();
+    }
+    if (type == ROTATION) {
+        proposal.angle = updateAngle(r.getAngle(), r.getRadius(), r.getLeftSpeed(),
+                                     r.getRightSpeed(), config.timePerFrame);
+    } else if (type == ARC) {
+        Pose pose = advancePose({r.getPosition(), r.getAngle()}, r.getRadius(),
+                                r.getLeftSpeed(), r.getRightSpeed(),
+                                config.timePerFrame);
+        proposal.angle = pose.angle;
+        proposal.position = pose.position;
+    } else {
+        proposal.position = updateCoordinate(r.getPosition(), r.getRightSpeed(),
+                                             headingTrig[index], config.timePerFrame);
+    }
+    if (config.exact) {
+        proposal.angle = snapFine(proposal.angle);
+        proposal.position = snapToGrid(proposal.position);
+    }
+}
+
+template <SimConfig Config>
+bool BasicSimulation<Config>::stepTwoPhase() {
+    // Flags for state creation
+    bool particleExploded = false;
+    bool commandSent = false;
+    bool particleEaten = false;
+    bool hasCollided = false;
+
+    stepArena.release();
+    manageParticleExplosion(timer, frame, particleExploded, particles, config,
+                            &stepArena);
+    if (particleExploded)
+        assignTargets();
+
+    // The lines of every robot at once, the same values as one by one
+    headings.resize(robots.size());
+    headingTrig.resize(robots.size());
+    for (size_t i = 0; i < robots.size(); ++i)
+        headings[i] = robots[i].getAngle();
+    sinCosBatch(headings, headingTrig);
+
+    // Robots near each other, only the pairs found by the broad phase are
+    // checked. A box holds the robot, the margin and the move of the frame,
+    // the pairs in contact once the first robot committed moved are all there
+    robotBoxes.resize(robots.size());
+    for (size_t i = 0; i < robots.size(); ++i) {
+        const Robot &r = robots[i];
+        double move = max(abs(r.getLeftSpeed()), abs(r.getRightSpeed()))
+                      * config.timePerFrame;
+        robotBoxes[i] = boxAround(r.getPosition(),
+                                  r.getRadius() + config.collisionEpsilon + move);
+    }
+    const vector<SweepPair> &pairs = robotSweep.update(robotBoxes);
+    // Counted two places ahead, each filled slot then moves the start of the
+    // next robot where it belongs
+    neighborStart.assign(robots.size() + 2, 0);
+    for (const SweepPair &pair: pairs) {
+        ++neighborStart[pair.first + 2];
+        ++neighborStart[pair.second + 2];
+    }
+    for (size_t i = 2; i < neighborStart.size(); ++i)
+        neighborStart[i] += neighborStart[i - 1];
+    // Room for a pair by robot like the broad phase, then doubled if needed
+    reserveFor(neighbors, 2 * max(pairs.size(), robots.size()));
+    neighbors.resize(2 * pairs.size());
+    for (const SweepPair &pair: pairs) {
+        neighbors[neighborStart[pair.first + 1]++] = pair.second;
+        neighbors[neighborStart[pair.second + 1]++] = pair.first;
+    }
+
+    // Parallel phase : particles touched and kinematics from the start of the
+    // frame
+    proposals.resize(robots.size());
+    TaskPool::shared().parallelFor(robots.size(),
+                                   [this](size_t i) { proposeMovement(i); });
+
+    // Serial phase : same decisions as the legacy step, in the same order. The
+    // contacts are those of the robots committed before, already moved
+    for (size_t index = 0; index < robots.size(); ++index) {
+        Robot &r = robots[index];
+        const Proposal &proposal = proposals[index];
+        bool hasCollidedWithParticle = false;
+        bool hasCollidedWithRobot = false;
+        Particle *p = findTargetParticle(r, particles);
+        Movement movement = movementMap[r.getId()];
+
+        Particle *blocking = nullptr;
+
+        if (movement.movementType != IDLE) {
+            bool robotCollider = movement.movementType != ROTATION &&
+                                 touchesNeighbor(index);
+            // The commit only removes particles, the robot touches no other
+            // than the ones of the frame start. A robot committed before may
+            // have eaten them, the next ones are then looked for
+            Particle *particleCollider = findParticle(particles,
+                                                      proposal.particleId);
+            if (particleCollider == nullptr && proposal.particleId != -1)
+                particleCollider = capturedParticle(r, particles, config);
+            if (particleCollider == nullptr && proposal.blockingId != -1)
+                blocking = findParticle(particles, proposal.blockingId);
+            if (particleCollider == nullptr && blocking == nullptr &&
+                movement.movementType != ROTATION &&
+                (proposal.particleId != -1 || proposal.blockingId != -1))
+                blocking = particleCollision(r, particles, config.collisionEpsilon,
+                                             config.exact);
+
+            if (robotCollider || particleCollider != nullptr || blocking != nullptr) {
+                movementMap[r.getId()] = initIdleMovement();
+                r.setSpeed(0, 0);
+                hasCollided = true;
+            }
+            if (robotCollider)
+                hasCollidedWithRobot = true;
+            if (particleCollider != nullptr) {
+                // Read before the erase, which moves the particles
+                int eatenId = particleCollider->getId();
+                r.setScore(r.getScore() + getArea(particleCollider->getRadius()));
+                particles.erase(remove_if(particles.begin(), particles.end(),
+                                          [=](const Particle &p) {
+                                              return p.getId() == eatenId;
+                                          }));
+                particleEaten = true;
+                hasCollidedWithParticle = true;
+            }
+        }
+
+        movement = movementMap[r.getId()];
+        if (movement.movementType == IDLE) {
+            if (blocking != nullptr && !hasCollidedWithRobot) {
+                movement = planCapture(r, *blocking);
+                r.setSpeed(movement.lSpeed, movement.rSpeed);
+                commandSent = true;
+            } else if (hasCollidedWithParticle || !hasCollidedWithRobot) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+                if (p != nullptr) {
+                    movement = planMovement(r, *p, constraints, config, moveMode);
+                    movementMap[r.getId()] = movement;
+                    r.setSpeed(movement.lSpeed, movement.rSpeed);
+                    commandSent = true;
+                }
+            }
+        } else if (movement.movementType == ROTATION) {
+            if (particleEaten || particleExploded) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+            }
+            double targetAngle = 0;
+            if (p != nullptr)
+                targetAngle = getAngle(r.getPosition(), p->getPosition());
+            if (p == nullptr || !isCommandFrame()) {
+                r.setAngle(proposal.angle);
+            } else if (!equal(targetAngle, r.getAngle(), config.angleTolerance)) {
+                if (isRotationStale(r, movement, *p, targetAngle)) {
+                    movement = planMovement(r, *p, constraints, config, TURN_AND_GO);
+                    r.setSpeed(movement.lSpeed, movement.rSpeed);
+                    movementMap[r.getId()] = movement;
+                    commandSent = true;
+                } else {
+                    r.setAngle(proposal.angle);
+                }
+            } else {
+                movement = initLineMovement(r, p->getPosition(), constraints,
+                                            p->getRadius(), config);
+                r.setSpeed(movement.lSpeed, movement.rSpeed);
+                movementMap[r.getId()] = movement;
+                commandSent = true;
+            }
+        } else if (movement.movementType == LINE) {
+            if (particleEaten || particleExploded)
+                assignTargets();
+            r.setPosition(proposal.position);
+        } else if (movement.movementType == ARC) {
+            if (particleEaten || particleExploded) {
+                assignTargets();
+                p = findTargetParticle(r, particles);
+            }
+            if (p != nullptr && isCommandFrame() && isOffCourse(r, *p)) {
+                movement = planMovement(r, *p, constraints, config, moveMode);
+                movementMap[r.getId()] = movement;
+                r.setSpeed(movement.lSpeed, movement.rSpeed);
+                commandSent = true;
+            } else {
+                r.setPosition(proposal.position);
+                r.setAngle(proposal.angle);
+            }
+        }
+    }
+
+    bool stateAdded = particleExploded || commandSent || particleEaten || hasCollided;
+    if (stateAdded)
+        addCurrentState();
+    nextFrame();
+    return stateAdded;
+}
+
+template <SimConfig Config>
+bool BasicSimulation<Config>::touchesNeighbor(std::size_t index) const {
+    const Robot &r = robots[index];
+    for (size_t k = neighborStart[index]; k < neighborStart[index + 1]; ++k) {
+        const Robot &other = robots[neighbors[k]];
+        if (r.getId() != other.getId() &&
+            touches(r.getPosition(), r.getRadius(), other.getPosition(),
+                    other.getRadius(), config.collisionEpsilon, config.exact))
+            return true;
+    }
+    return false;
+}
+
+template <SimConfig Config>
+bool BasicSimulation<Config>::isCommandFrame() const {
+    return ::isCommandFrame(timer, constraints.commandTimeInterval,
+                            config.timePerFrame, COMMAND_TIME_TOLERANCE);
+}
+
+template <SimConfig Config>
+void BasicSimulation<Config>::nextFrame() {
+    ++frame;
+    // 1/24 is not a double, a sum of frames drifts
+    if (config.exact)
+        timer = frameToTime(frame, config.framePerSec);
+    else
+        timer += config.timePerFrame;
+}
+
+template class BasicSimulation<DefaultSimConfig>;
+template class BasicSimulation<ExactSimConfig>;
+template class BasicSimulation<RuntimeSimConfig>;
+
+template std::vector<State> simulateFrom(const State &, const Constraints &,
+                                         const DefaultSimConfig &, StepMode, MoveMode,
+                                         TargetMode);
+template std::optional<std::vector<State>>
+simulateFrom(std::span<const State>, std::size_t, const State *, const Constraints &,
+             const DefaultSimConfig &, StepMode, MoveMode, TargetMode);
+template std::vector<State> simulateFrom(const std::string &, std::size_t,
+                                         const State *, const DefaultSimConfig &);
+template std::vector<State> simulateFrom(const State &, const Constraints &,
+                                         const ExactSimConfig &, StepMode, MoveMode,
+                                         TargetMode);
+template std::optional<std::vector<State>>
+simulateFrom(std::span<const State>, std::size_t, const State *, const Constraints &,
+             const ExactSimConfig &, StepMode, MoveMode, TargetMode);
+template std::vector<State> simulateFrom(const std::string &, std::size_t,
+                                         const State *, const ExactSimConfig &);
+template std::vector<State> simulateFrom(const State &, const Constraints &,
+                                         const RuntimeSimConfig &, StepMode, MoveMode,
+                                         TargetMode);
+template std::optional<std::vector<State>>
+simulateFrom(std::span<const State>, std::size_t, const State *, const Constraints &,
+             const RuntimeSimConfig &, StepMode, MoveMode, TargetMode);
+template std::vector<State> simulateFrom(const std::string &, std::size_t,
+                                         const State *, const RuntimeSimConfig &);
+
+template <SimConfig Config>
+double syncTime(double time, const Constraints &con, const Config &config) {
+    if (config.exact)
+        return getExactSyncTime(time, con.commandTimeInterval, config.timePerFrame);
+    return getSyncTime(time, con.commandTimeInterval, config.timePerFrame);
+}
+
+template <SimConfig Config>
+Movement initRotation(Robot &r, Position pPos, Constraints con, const Config &config) {
+    // Calculate the angle that we need to rotate with deltaX and deltaY
+    double targetAngle = getAngle(r.getPosition(), pPos);
+
+    // Calculate the difference between the 2 angles
+    double effectiveAngle = deltaAngle(r.getAngle(), targetAngle);
+
+    //Manage the direction of rotation to rotate the minimum distance
+    AngularDirection dir = rotateShortestPath(r.getAngle(), targetAngle);
+
+    //Calculate the rotation time with maximum speed (left & right must be equal)
+    double maxRotationSpeed = min(con.maxBackwardSpeed, con.maxForwardSpeed);
+
+    //Inverse rotationSpeed if CCW
+    if (dir == CCW)
+        maxRotationSpeed = -maxRotationSpeed;
+
+    // Get the angular speed in rad/s
+    double omega = angularSpeed(r.getRadius(), maxRotationSpeed, -maxRotationSpeed);
+
+    // Now get the time that the rotation takes
+    double time = rotationTime(effectiveAngle, omega);
+
+    //Avoid precision problems
+    double syncedTime = syncTime(time, con, config);
+
+    // Calculate the new speed synced to the time contraints
+    if (dir == CW)
+        omega = effectiveAngle / syncedTime;
+    else
+        omega = -effectiveAngle / syncedTime;
+
+    double syncedSpeed = (omega * 2 * r.getRadius()) / 2;
+    if (config.exact)
+        syncedSpeed = snapFine(syncedSpeed);
+
+    Movement rotMovement = {ROTATION, syncedSpeed, -syncedSpeed};
+    return rotMovement;
+}
+
+template <SimConfig Config>
+Movement initLineMovement(Robot &r, Position pPos, Constraints con, double pRadius,
+                          const Config &config) {
+    //TODO ALIGNEMENT AVEC TIMER
+    double distance =
+            linearDistance(r.getPosition(), pPos) - r.getRadius() - pRadius;
+    double time = distance / con.maxForwardSpeed;
+    double syncedTime = syncTime(time, con, config);
+    double syncedSpeed = distance / syncedTime;
+    if (config.exact)
+        syncedSpeed = snapFine(syncedSpeed);
+    Movement linearMovement = {LINE, syncedSpeed, syncedSpeed};
+    return linearMovement;
+}
+
+template <SimConfig Config>
+Movement initArcMovement(const ArcPlan &plan, Constraints con, const Config &config) {
+    // Slowed down to end one frame before a command time, like the line, but
+    // never above the planned speeds
+    double syncedTime = syncTime(plan.time, con, config);
+    double ratio = min(1.0, plan.time / syncedTime);
+    double lSpeed = plan.leftSpeed * ratio, rSpeed = plan.rightSpeed * ratio;
+    if (config.exact) {
+        lSpeed = snapFine(lSpeed);
+        rSpeed = snapFine(rSpeed);
+    }
+    return Movement{ARC, lSpeed, rSpeed};
+}
+
+template <SimConfig Config>
+Movement planMovement(Robot &r, const Particle &p, const Constraints &con,
+                      const Config &config, MoveMode moveMode) {
+    double targetAngle = getAngle(r.getPosition(), p.getPosition());
+    ArcPlan plan;
+    if (moveMode == ARC_MOVES &&
+        planArc({r.getPosition(), r.getAngle()}, r.getRadius(),
+                r.getCaptureAngle(RAD), p.getPosition(),
+                r.getRadius() + p.getRadius(), con, plan)) {
+        // The arc is slower than the line, only taken when it saves the turn
+        double rotationSpeed = min(con.maxBackwardSpeed, con.maxForwardSpeed);
+        double turnTime = deltaAngle(r.getAngle(), targetAngle) * r.getRadius() /
+                          rotationSpeed;
+        double lineTime = (linearDistance(r.getPosition(), p.getPosition()) -
+                           r.getRadius() - p.getRadius()) / con.maxForwardSpeed;
+        double turnAndGo = syncTime(lineTime, con, config);
+        if (!equal(targetAngle, r.getAngle(), config.angleTolerance))
+            turnAndGo += syncTime(turnTime, con, config);
+        if (syncTime(plan.time, con, config) <= turnAndGo)
+            return initArcMovement(plan, con, config);
+    }
+
+    if (!equal(targetAngle, r.getAngle(), config.angleTolerance)) {
+        Movement rotation = initRotation(r, p.getPosition(), con, config);
+        rotation.targetId = p.getId();
+        return rotation;
+    }
+    // Rotation is finished, now go in straight line to the particle
+    return initLineMovement(r, p.getPosition(), con, p.getRadius(), config);
+}
+
+bool isRotationStale(const Robot &r, const Movement &movement, const Particle &p,
+                     double targetAngle) {
+    AngularDirection turning = r.getLeftSpeed() > 0 ? CW : CCW;
+    return (movement.targetId != -1 && movement.targetId != p.getId()) ||
+           rotateShortestPath(r.getAngle(), targetAngle) != turning;
+}
+
+bool isOffCourse(const Robot &r, const Particle &p) {
+    return arcMiss({r.getPosition(), r.getAngle()}, r.getRadius(), r.getLeftSpeed(),
+                   r.getRightSpeed(), p.getPosition()) > ARC_MISS_TOLERANCE;
+}
+
+Movement initIdleMovement() {
+    return Movement{IDLE, 0, 0};
+}
+
+Movement movementFromSpeeds(const Robot &r) {
+    double lSpeed = r.getLeftSpeed(), rSpeed = r.getRightSpeed();
+    if (lSpeed == 0 && rSpeed == 0)
+        return initIdleMovement();
+    // Opposite wheel speeds turn the robot on itself
+    if (lSpeed == -rSpeed)
+        return Movement{ROTATION, lSpeed, rSpeed};
+    if (lSpeed != rSpeed)
+        return Movement{ARC, lSpeed, rSpeed};
+    return Movement{LINE, lSpeed, rSpeed};
+}
+
+bool allRobotsStopped(map<int, Movement> &movementMap) {
+    for (auto &[id, movement]: movementMap) {
+        if (movement.movementType != IDLE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasExploded(const Particle &p, double currentTime, double tolerance) {
+    // Reached within the tolerance, the same frame as firstFrameAfter
+    return p.getExplosionTimes().at(0).at(0) <= currentTime + tolerance;
+}
+
+bool hasExplodedAt(const Particle &p, int64_t frame, int framePerSec,
+                   double tolerance) {
+    double time = p.getExplosionTimes().at(0).at(0);
+    return frame >= firstFrameAfter(time, framePerSec, tolerance);
+}
+
+bool touches(const Position &p1, double radius1, const Position &p2,
+             double radius2, double epsilon, bool exact) {
+    if (exact)
+        return detectCollisionFixed(p1, radius1, p2, radius2, epsilon);
+    return detectCollision(p1, radius1, p2, radius2, epsilon);
+}
+
+bool robotCollision(const Robot &r1, const vector<Robot> &robs, double epsilon,
+                    bool exact) {
+    for (const Robot &robot: robs) {
+        if (r1.getId() != robot.getId() &&
+            touches(r1.getPosition(), r1.getRadius(), robot.getPosition(),
+                    robot.getRadius(), epsilon, exact)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool inCaptureAngle(const Robot &r, const Particle &p, double angleTolerance) {
+    double toParticle = getAngle(r.getPosition(), p.getPosition());
+    // A robot facing the particle within the tolerance of the engine is aligned
+    return abs(remainder(toParticle - r.getAngle(), 2 * M_PI)) <=
+           max(r.getCaptureAngle(RAD), angleTolerance);
+}
+
+template <SimConfig Config>
+Particle *capturedParticle(const Robot &r, vector<Particle> &particles,
+                           const Config &config) {
+    for (Particle &p: particles) {
+        if (touches(r.getPosition(), r.getRadius(), p.getPosition(), p.getRadius(),
+                    config.collisionEpsilon, config.exact) &&
+            inCaptureAngle(r, p, config.angleTolerance))
+            return &p;
+    }
+    return nullptr;
+}
+
+Particle *particleCollision(const Robot &r1, vector<Particle> &particles,
+                           double epsilon, bool exact) {
+    for (Particle &p: particles) {
+        if (touches(r1.getPosition(), r1.getRadius(), p.getPosition(),
+                    p.getRadius(), epsilon, exact)) {
+            return &p;
+        }
+    }
+    return nullptr;
+}
+
+map<int, Movement> initRobots(vector<Robot> &robots, MovementType status) {
+    map<int, Movement> movementMap;
+    for (Robot &rob: robots) {
+        // Set the robots to idle
+        movementMap[rob.getId()] = {status, 0, 0};
+    }
+    return movementMap;
+}
+
+json movementToJson(const Movement &m) {
+    return {{"type",           m.movementType},
+            {"leftSpeed",      m.lSpeed},
+            {"rightSpeed",     m.rSpeed},
+            {"rotationTarget", m.targetId},
+            {"capture",        m.capture}};
+}
+
+Movement movementFromJson(const json &m) {
+    return {m.at("type").get<MovementType>(), m.at("leftSpeed").get<double>(),
+            m.at("rightSpeed").get<double>(), m.value("rotationTarget", -1),
+            m.value("capture", false)};
+}
+
+json engineToJson(const EngineRecord &record) {
+    json movements = json::array();
+    for (const Movement &m: record.movements)
+        movements.push_back(movementToJson(m));
+    json engine = {{"frame",     record.frame},
+                   {"timer",     record.timer},
+                   {"targets",   record.targets},
+                   {"movements", std::move(movements)}};
+    if (record.routes)
+        engine["routes"] = *record.routes;
+    return engine;
+}
+
+EngineRecord engineFromJson(const json &engine) {
+    EngineRecord record{engine.at("frame").get<int64_t>(),
+                        engine.at("timer").get<double>(),
+                        engine.at("targets").get<vector<int>>(), {}, nullopt};
+    for (const json &m: engine.at("movements"))
+        record.movements.push_back(movementFromJson(m));
+    if (engine.contains("routes"))
+        record.routes = engine.at("routes").get<RoutePlanner>();
+    return record;
+}
+
+uint64_t appendStates(ostream &os, span<const State> states,
+                      span<const EngineRecord> records, vector<uint64_t> &offsets,
+                      uint64_t position) {
+    size_t first = states.size() - min(records.size(), states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        json angles = json::array();
+        for (const Robot &r: states[i].getRobots())
+            angles.push_back(r.getAngle());
+        json record = {{"state", states[i]}, {"angles", std::move(angles)}};
+        if (i >= first)
+            record["engine"] = engineToJson(records[i - first]);
+        vector<uint8_t> bytes = json::to_cbor(record);
+        os.write(reinterpret_cast<const char *>(bytes.data()), streamsize(bytes.size()));
+        offsets.push_back(position);
+        position += bytes.size();
+    }
+    return position;
+}
+
+State readState(const json &record) {
+    // A round trip in degrees is not exact, the angles are set back in radians
+    State state = record.at("state").get<State>();
+    const json &angles = record.at("angles");
+    RobotList &robots = state.getRobots();
+    for (size_t i = 0; i < robots.size() && i < angles.size(); ++i)
+        robots[i].setAngle(angles[i].get<double>());
+    return state;
+}
+
+void assignAllNearestParticle(vector<Robot> &robots, const CostMatrix &costs) {
+    //The robots select the nearest particle automatically
+    if(costs.getParticleCount() < 1)
+        return;
+    for (size_t i = 0; i < robots.size(); ++i) {
+        Robot &rob = robots[i];
+        assignNearestParticle(rob, i, costs);
+        //if assigned particle == other robots assigned particle, then change it
+        auto samePartRob = find_if(robots.begin(), robots.end(),[&](const Robot &r)
+        {
+            if(r.getTargetParticleId()!= -1 && r.getId() != rob.getId()) {
+                return r.getTargetParticleId() == rob.getTargetParticleId();
+            }
+            return false;
+        });
+
+        if(rob.getTargetParticleId() != -1 && samePartRob != robots.end()){
+            // Nearest particle apart from the one already taken
+            assignNearestParticle(rob, i, costs, rob.getTargetParticleId());
+        }
+    }
+}
+
+void assignNearestParticle(Robot &robot, size_t row, const CostMatrix &costs,
+                           int excludedId) {
+    long nearest = costs.findNearest(row, excludedId);
+    robot.setTargetParticleId(nearest == -1 ? -1 : costs.getParticleId(nearest));
+}
+
+void snapToGrid(vector<Robot> &robots, vector<Particle> &particles) {
+    for (Robot &r: robots) {
+        r.setPosition(snapToGrid(r.getPosition()));
+        r.setAngle(snapFine(r.getAngle()));
+    }
+    for (Particle &p: particles)
+        p = Particle(p.getId(), snapToGrid(p.getPosition()), p.getRadius(),
+                     p.getExplosionTimes());
+}
+
+template <SimConfig Config>
+void manageParticleExplosion(double timer, int64_t frame, bool &explosionHappened,
+                             vector<Particle> &particles, const Config &config,
+                             pmr::memory_resource *arena) {
+    if (particles.empty())
+        return;
+    int maxId = std::max_element(particles.begin(), particles.end(),
+                                 [](const Particle &p1, const Particle &p2) {
+                                     return p1.getId()
+                                            < p2.getId();
+                                 })->getId();
+
+    // Particles exploding at this frame, the children only explode later
+    pmr::vector<int> explodedIds(arena);
+    for (const Particle &particle: particles) {
+        try {
+            bool exploded = config.exact
+                            ? hasExplodedAt(particle, frame, config.framePerSec,
+                                            config.explosionTolerance)
+                            : hasExploded(particle, timer,
+                                          config.explosionTolerance);
+            if (exploded)
+                explodedIds.push_back(particle.getId());
+        }
+        catch (exception &e) {
+            cerr << "Id : " << particle.getId()
+            << " Timer : " << timer << endl
+            << "What " << e.what() << endl;
+            throw;
+        }
+    }
+
+    for (int id: explodedIds) {
+        const Particle &particle = *find_if(particles.begin(), particles.end(),
+                                            [=](const Particle &p) {
+                                                return p.getId() == id;
+                                            });
+        // Read before the children are added, the vector may move. The
+        // explosion times are shared and stay in place
+        Position center = particle.getPosition();
+        double parentRadius = particle.getRadius();
+        const ExplosionTimes &currentExplosionTime = particle.getExplosionTimes();
+        if (currentExplosionTime.size() > 1) {
+            double radius = ((parentRadius * 2) / (1 + SQRT2)) / 2;
+            Position newPos[] = {
+                    Position(center.getX() - radius, center.getY() - radius),
+                    Position(center.getX() - radius, center.getY() + radius),
+                    Position(center.getX() + radius, center.getY() - radius),
+                    Position(center.getX() + radius, center.getY() + radius)};
+            if (config.exact) {
+                for (Position &pos: newPos)
+                    pos = snapToGrid(pos);
+            }
+            unsigned index = 0;
+            for (double childTime: currentExplosionTime.at(1)) {
+                maxId++;
+                // Moved into the particle, a child allocates its list, one
+                // vector by level and the shared block
+                ExplosionTimes newExplosionTimes;
+                newExplosionTimes.reserve(currentExplosionTime.size() > 2 ? 2 : 1);
+                newExplosionTimes.push_back({childTime});
+                if (currentExplosionTime.size() > 2) {
+                    //Push back each child vector
+                    newExplosionTimes.push_back(
+                            {currentExplosionTime.at(2).at(index * 4u),
+                             currentExplosionTime.at(2).at(index * 4 + 1u),
+                             currentExplosionTime.at(2).at(index * 4 + 2u),
+                             currentExplosionTime.at(2).at(index * 4 + 3u)});
+                }
+                //Create 4 new particles
+                particles.emplace_back(maxId, newPos[index], radius,
+                                       std::move(newExplosionTimes));
+                index++;
+            }
+        }
+        explosionHappened = true;
+        //Erase the exploded particle
+        particles.erase(remove_if(particles.begin(), particles.end(),
+                                  [=](const Particle &p) {
+                                      return p.getId() == id;
+                                  }));
+    }
+}
+
+
+Particle *findParticle(vector<Particle> &particles, int id) {
+    auto p = find_if(particles.begin(), particles.end(), [=](const Particle &p) {
+        return p.getId() == id;
+    });
+    return p != particles.end() ? &*p : nullptr;
+}
+
+Particle *findTargetParticle(const Robot &r, vector<Particle> &particles) {
+    return findParticle(particles, r.getTargetParticleId());
+}
+
+bool sameState(const State &a, const State &b, double timeTolerance) {
+    auto near = [](double x, double y) { return abs(x - y) <= STATE_TOLERANCE; };
+    auto nearPosition = [&](const Position &p, const Position &q) {
+        return near(p.getX(), q.getX()) && near(p.getY(), q.getY());
+    };
+    const RobotList &robotsA = a.getRobots(), &robotsB = b.getRobots();
+    const ParticleList &particlesA = a.getParticles(), &particlesB = b.getParticles();
+    if (abs(a.getTime() - b.getTime()) > timeTolerance ||
+        robotsA.size() != robotsB.size() || particlesA.size() != particlesB.size())
+        return false;
+    for (size_t i = 0; i < robotsA.size(); ++i) {
+        const Robot &ra = robotsA[i], &rb = robotsB[i];
+        if (ra.getId() != rb.getId() || !nearPosition(ra.getPosition(), rb.getPosition())
+            || !near(ra.getAngle(DEG), rb.getAngle(DEG))
+            || !near(ra.getLeftSpeed(), rb.getLeftSpeed())
+            || !near(ra.getRightSpeed(), rb.getRightSpeed())
+            || !near(ra.getScore(), rb.getScore()))
+            return false;
+    }
+    for (size_t i = 0; i < particlesA.size(); ++i) {
+        const Particle &pa = particlesA[i], &pb = particlesB[i];
+        if (pa.getId() != pb.getId() || !nearPosition(pa.getPosition(), pb.getPosition())
+            || !near(pa.getRadius(), pb.getRadius()))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,310 @@
+/*-----------------------------------------------------------------------------
+File name : simulation.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the simulation engine generating a timeline frame by
+frame from a base state. The whole engine state can be saved in a checkpoint
+and a simulation resumed from it gives the same timeline. The generated states
+are appended to a journal next to the checkpoint, each save only adds the new
+ones, and a fork of the checkpoint starts at any of them. The engine is a
+template on its configuration (simconfig.h), compiled for DefaultSimConfig,
+ExactSimConfig and RuntimeSimConfig in simulation.cpp.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "timeline.h"
+#include "state.h"
+#include "robot.h"
+#include "particle.h"
+#include "position.h"
+#include "simconfig.h"
+#include "costmatrix.h"
+#include "fasttrig.h"
+#include "routing.h"
+#include "sweepprune.h"
+
+const std::size_t STEP_ARENA_SIZE = 4096; // bytes of temporaries per frame
+
+typedef enum {
+    IDLE, ROTATION, LINE, ARC
+} MovementType;
+
+typedef enum {
+    BASE_STATE,    // first state of a new timeline, simulated from time 0
+    TIMELINE_STATE // state of a generated timeline, simulated from the next frame
+} StartMode;
+
+typedef enum {
+    LEGACY_STEP,   // robots updated one after the other, as originally
+    TWO_PHASE_STEP // robots computed in parallel on the state at the start of
+                   // the frame, then committed one after the other in the
+                   // order of the legacy step, giving the same timeline
+} StepMode;
+
+typedef enum {
+    TURN_AND_GO, // the robot turns on itself toward its target, then goes straight
+    ARC_MOVES    // a target in front is reached on an arc, without stopping
+} MoveMode;
+
+typedef enum {
+    NEAREST_TARGET, // every robot goes to its nearest particle
+    ROUTED_TARGETS  // the robots follow the routes of a RoutePlanner
+} TargetMode;
+
+struct Movement {
+    MovementType movementType;
+    double lSpeed;
+    double rSpeed;
+    int targetId = -1; // particle a rotation turns toward, -1 if unknown
+    bool capture = false; // turning to decontaminate the particle it touches
+};
+
+// Engine data of a timeline state that the state does not hold, the frame
+// following the state starts with it and the bodies of the state
+struct EngineRecord {
+    std::int64_t frame;
+    double timer;
+    std::vector<int> targets; // in the robot order of the state
+    std::vector<Movement> movements;
+    std::optional<RoutePlanner> routes; // routed targets only
+};
+
+template <SimConfig Config = DefaultSimConfig>
+class BasicSimulation {
+
+public:
+    // From a timeline state, the movements are rebuilt from the robot speeds
+    BasicSimulation(const State &initialState, const Constraints &constraints,
+                    StartMode mode = BASE_STATE, const Config &config = Config());
+
+    // Resume from a checkpoint saved by saveCheckpoint. A runtime configuration
+    // takes the frame rate and the mode of the checkpoint, the others must
+    // have them
+    explicit BasicSimulation(const std::string &checkpointPath,
+                             const Config &config = Config());
+
+    // Resume at a state of the checkpoint journal, from the engine data saved
+    // with it. The timeline starts with that state, the only one read from the
+    // journal, nothing is simulated
+    BasicSimulation(const std::string &checkpointPath, std::size_t stateIndex,
+                    const Config &config = Config());
+
+    const Config &getConfig() const { return config; }
+
+    // The two phase step runs on the shared task pool and gives the same
+    // timeline for any number of threads
+    void setStepMode(StepMode mode) { stepMode = mode; }
+
+    StepMode getStepMode() const { return stepMode; }
+
+    void setMoveMode(MoveMode mode) { moveMode = mode; }
+
+    MoveMode getMoveMode() const { return moveMode; }
+
+    // The routes are planned when the mode is set, then updated on the events.
+    // Nothing is done if the mode does not change
+    void setTargetMode(TargetMode mode);
+
+    TargetMode getTargetMode() const { return targetMode; }
+
+    // Keep the engine data of the new states, written with them in the journal
+    // of the checkpoints. A fork of the checkpoint then starts at the fork
+    // state. Set before the first step
+    void setRecordEngine(bool record);
+
+    // Simulate one frame, return true if a state was added to the timeline
+    bool step();
+
+    // True once the last state of the timeline has no particle left
+    bool isFinished() const;
+
+    double getTime() const { return timer; }
+
+    // Frames simulated since time 0
+    std::int64_t getFrame() const { return frame; }
+
+    Timeline &getTimeline() { return timeline; }
+
+    const Constraints &getConstraints() const { return constraints; }
+
+    // The robots and particles of the last state become the ones of state, an
+    // edited copy of it. The robots keep their movement if their speeds did
+    // not change and their target if it is still there, the routes are
+    // planned again
+    void replaceCurrentState(const State &state);
+
+    // Compact binary file holding the engine state, the generated states are
+    // in <path>.states. The journal is written whole on the first save to a
+    // path, the next saves append the states added since the previous one
+    void saveCheckpoint(const std::string &path);
+
+private:
+    [[no_unique_address]] Config config;
+    Timeline timeline;
+    Constraints constraints;
+    Position worldOrigin, worldEnd;
+    std::vector<Robot> robots;          // working copies of the last frame
+    std::vector<Particle> particles;
+    std::map<int, Movement> movementMap; // robot id->movement
+    double timer = 0;
+    std::int64_t frame = 0; // the timer is computed from it in exact mode
+    StepMode stepMode = LEGACY_STEP;
+    MoveMode moveMode = TURN_AND_GO;
+    TargetMode targetMode = NEAREST_TARGET;
+    CostMatrix costMatrix{config.angleTolerance};
+    RoutePlanner routePlanner;
+    std::string journalPath;      // states journal of the last checkpoint
+    std::size_t journalStates = 0; // states written in it
+    std::vector<std::uint64_t> journalOffsets; // position of each of them
+    std::uint64_t journalEnd = 0;               // bytes of the journal
+    bool recordEngine = false;
+    std::vector<EngineRecord> engineRecords; // last states, not journaled yet
+
+    // Result of the parallel phase for one robot. The particles found are
+    // the first ones of the frame start, the commit looks again for the next
+    // ones when a robot committed before ate them
+    struct Proposal {
+        int particleId = -1; // first touched in the capture angle, -1 if none
+        int blockingId = -1; // first touched before it when moving, -1 if none
+        double angle = 0;    // angle after one frame of rotation or arc (radians)
+        Position position;   // position after one frame of line or arc
+    };
+    std::vector<Proposal> proposals;
+    std::vector<double> headings;   // angles of the robots at the frame start
+    std::vector<SinCos> headingTrig; // their sines and cosines, in one batch
+    SweepAndPrune robotSweep;
+    std::vector<SweepBox> robotBoxes;
+    // Robots the boxes of the broad phase put near each robot, those of robot
+    // i from neighborStart[i] to neighborStart[i + 1]. The boxes are grown by
+    // the move of the frame, the commit tests the robots already moved
+    std::vector<std::size_t> neighborStart;
+    std::vector<std::size_t> neighbors;
+
+    // Temporaries of one frame, released at the start of the next one. Only
+    // goes to the heap when a frame needs more than the buffer
+    std::array<std::byte, STEP_ARENA_SIZE> stepBuffer;
+    std::pmr::monotonic_buffer_resource stepArena{stepBuffer.data(),
+                                                  stepBuffer.size()};
+
+    // Version, frame rate, modes, constraints and world of the checkpoint
+    json readCheckpoint(const std::string &checkpointPath);
+
+    EngineRecord currentEngine() const;
+
+    // The robots of the timeline state are at the given engine data
+    void restoreEngine(const EngineRecord &record);
+
+    // The robot angles are first rounded to the degrees written in the
+    // files, a state read again then continues as the simulation did
+    void addCurrentState();
+
+    bool stepLegacy();
+
+    bool stepTwoPhase();
+
+    void proposeMovement(std::size_t index);
+
+    // Neighbors of the broad phase in contact with the robot, where the robots
+    // committed before it are now
+    bool touchesNeighbor(std::size_t index) const;
+
+    // Target particle of every robot, from the mode
+    void assignTargets();
+
+    // Stopped against the particle out of its capture angle, the robot turns
+    // toward it
+    Movement planCapture(Robot &r, const Particle &p);
+
+    // A multiple of the command interval falls in this frame or the next one,
+    // out of the collisions the robots are only given new speeds then
+    bool isCommandFrame() const;
+
+    void nextFrame();
+};
+
+extern template class BasicSimulation<DefaultSimConfig>;
+extern template class BasicSimulation<ExactSimConfig>;
+extern template class BasicSimulation<RuntimeSimConfig>;
+
+using Simulation = BasicSimulation<>;
+
+// States following startState, the timeline is simulated again from it until
+// every particle is cleaned. startState is usually an edited timeline state.
+// The targets are chosen again from the state, and the routes planned again,
+// the states may differ from the ones of the run that gave startState
+template <SimConfig Config = DefaultSimConfig>
+std::vector<State> simulateFrom(const State &startState,
+                                const Constraints &constraints,
+                                const Config &config = Config(),
+                                StepMode stepMode = LEGACY_STEP,
+                                MoveMode moveMode = TURN_AND_GO,
+                                TargetMode targetMode = NEAREST_TARGET);
+
+// States following the state index of source. A timeline does not hold the
+// engine data, the run is simulated again from the first state of source up
+// to that state, the targets, the routes and the movements at the fork are
+// then the ones of the run, and a fork without edit gives the states of
+// source. editedState, if not null, replaces the fork state. Empty if the
+// states simulated again are not the ones of source, the timeline was made
+// with other options or was edited before the fork
+template <SimConfig Config = DefaultSimConfig>
+std::optional<std::vector<State>> simulateFrom(std::span<const State> source,
+                                               std::size_t index,
+                                               const State *editedState,
+                                               const Constraints &constraints,
+                                               const Config &config = Config(),
+                                               StepMode stepMode = LEGACY_STEP,
+                                               MoveMode moveMode = TURN_AND_GO,
+                                               TargetMode targetMode = NEAREST_TARGET);
+
+// States following the state index of the checkpoint journal, with the modes
+// and the constraints of the checkpoint. The simulation starts at the fork
+// state from the engine data saved with it, only that state is read and only
+// the states after it are simulated. editedState, if not null, replaces the
+// fork state
+template <SimConfig Config = DefaultSimConfig>
+std::vector<State> simulateFrom(const std::string &checkpointPath,
+                                std::size_t index, const State *editedState,
+                                const Config &config = Config());
+
+// States of the checkpoint journal, the robot angles in radians
+Timeline loadCheckpointStates(const std::string &checkpointPath);
+
+extern template std::vector<State> simulateFrom(const State &, const Constraints &,
+                                                const DefaultSimConfig &, StepMode,
+                                                MoveMode, TargetMode);
+extern template std::optional<std::vector<State>>
+simulateFrom(std::span<const State>, std::size_t, const State *, const Constraints &,
+             const DefaultSimConfig &, StepMode, MoveMode, TargetMode);
+extern template std::vector<State> simulateFrom(const std::string &, std::size_t,
+                                                const State *, const DefaultSimConfig &);
+extern template std::vector<State> simulateFrom(const State &, const Constraints &,
+                                                const ExactSimConfig &, StepMode,
+                                                MoveMode, TargetMode);
+extern template std::optional<std::vector<State>>
+simulateFrom(std::span<const State>, std::size_t, const State *, const Constraints &,
+             const ExactSimConfig &, StepMode, MoveMode, TargetMode);
+extern template std::vector<State> simulateFrom(const std::string &, std::size_t,
+                                                const State *, const ExactSimConfig &);
+extern template std::vector<State> simulateFrom(const State &, const Constraints &,
+                                                const RuntimeSimConfig &, StepMode,
+                                                MoveMode, TargetMode);
+extern template std::optional<std::vector<State>>
+simulateFrom(std::span<const State>, std::size_t, const State *, const Constraints &,
+             const RuntimeSimConfig &, StepMode, MoveMode, TargetMode);
+extern template std::vector<State> simulateFrom(const std::string &, std::size_t,
+                                                const State *, const RuntimeSimConfig &);
+
+#endif // SIMULATION_H
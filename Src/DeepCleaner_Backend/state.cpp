@@ -11,8 +11,9 @@ Compiler : Mingw-w64 g++ 11.2.0
 #include <utility>
 #include "state.h"
 #include "utils.h"
+#include "saxreader.h"
 
-State::State(const std::string &path) {
+State::State(const std::string &path) : State() {
 	try {
 		deserialize(path);
 	}
@@ -22,40 +23,60 @@ State::State(const std::string &path) {
 	}
 }
 
-State::State(double time, Position worldOrigin, Position worldEnd, std::vector<Robot>
-robots, std::vector<Particle> particles) {
+State::State(double time, Position worldOrigin, Position worldEnd,
+			 const std::vector<Robot> &robots,
+			 const std::vector<Particle> &particles) : State() {
 	this->time = time;
 	this->worldOrigin = worldOrigin;
 	this->worldEnd = worldEnd;
-	this->robots = std::move(robots);
-	this->particles = std::move(particles);
+	this->robots.assign(robots.begin(), robots.end());
+	this->particles.assign(particles.begin(), particles.end());
 }
 
-void State::serialize(const std::string &outputPath, const std::string &fileName) {
+State::State(const State &other) : time(other.time),
+											  worldOrigin(other.worldOrigin),
+											  worldEnd(other.worldEnd),
+											  robots(other.robots, snapshotPool()),
+											  particles(other.particles, snapshotPool()),
+											  fileExtension(other.fileExtension) {}
+
+std::pmr::memory_resource *State::snapshotPool() {
+	// Synchronized, the states are built and destroyed on several threads
+	static std::pmr::synchronized_pool_resource pool;
+	return &pool;
+}
+
+void State::serialize(const std::string &outputPath, const std::string &fileName) const {
 	serialize(outputPath + addExtension(fileName, this->fileExtension));
 }
 
-void State::serialize(const std::string &outputPath) {
+void State::serialize(const std::string &outputPath, FileFormat format) const {
 	std::ofstream ofs;
 	json st_j = *this;
 	try {
-		ofs.open(outputPath);
+		ofs.open(outputPath, isBinaryFormat(format) ?
+				 std::ios::out | std::ios::binary : std::ios::out);
 	}
 	catch (std::ios_base::failure &e) {
 		throw "Error creating the file \'" + outputPath + "\' : " + e.what();
 	}
-	ofs << std::setw(4) << st_j;
+	writeDocument(ofs, st_j, format);
 	ofs.close();
 }
 
 void State::deserialize(const std::string &fileName) {
-	std::ifstream f(fileName);
-	json data = json::parse(f);
-	this->time = data.get<State>().time;
-	this->worldOrigin = data.get<State>().worldOrigin;
-	this->worldEnd = data.get<State>().worldEnd;
-	this->robots = data.get<State>().robots;
-	this->particles = data.get<State>().particles;
+	std::ifstream f(fileName, std::ios::binary);
+	deserialize(f);
+}
+
+void State::deserialize(std::istream &input) {
+	bool found = false;
+	// Built straight from the parser events, the first state is kept
+	readStates(input, [&](State &&s) {
+		if (!found)
+			*this = std::move(s);
+		found = true;
+	});
 }
 
 std::ostream &operator<<(std::ostream &os, const State &s) {
@@ -63,11 +84,3 @@ std::ostream &operator<<(std::ostream &os, const State &s) {
 	std::cout << std::setw(4) << s_j << '\n';
 	return os;
 }
-
-Position State::getWorldEnd() {
-	return this->worldEnd;
-}
-
-Position State::getWorldOrigin() {
-	return this->worldOrigin;
-}
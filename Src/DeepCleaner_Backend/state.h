@@ -9,54 +9,79 @@ Compiler : Mingw-w64 g++ 11.2.0
 #ifndef STATE_H
 #define STATE_H
 
+#include <memory_resource>
 #include <utility>
 #include <vector>
 #include "robot.h"
 #include "particle.h"
 #include "position.h"
 #include "json.hpp"
+#include "fileformat.h"
 
 using json = nlohmann::json;
 
+// The lists of every state are taken from the same pool, the memory of the
+// discarded states is reused by the next ones
+using RobotList = std::pmr::vector<Robot>;
+using ParticleList = std::pmr::vector<Particle>;
+
 class State {
 
 public:
-	State() : time(0.0), worldOrigin(Position()), worldEnd(Position()), robots
-		(std::vector<Robot>()), particles(std::vector<Particle>()) {}
+	State() : time(0.0), worldOrigin(Position()), worldEnd(Position()),
+				 robots(snapshotPool()), particles(snapshotPool()) {}
 
 	State(const std::string &path);
 
-	State(double time, Position worldOrigin, Position worldEnd, std::vector<Robot>
-	robots, std::vector<Particle>);
+	State(double time, Position worldOrigin, Position worldEnd,
+			const std::vector<Robot> &robots, const std::vector<Particle> &particles);
+
+	// A copy takes its memory from the pool too, not from the default resource
+	State(const State &other);
+
+	State(State &&other) noexcept = default;
+
+	State &operator=(const State &other) = default;
+
+	State &operator=(State &&other) = default;
 
-	std::vector<Robot> getRobots() { return robots; }
+	RobotList &getRobots() { return robots; }
 
-	std::vector<Particle> &getParticles() { return particles; }
+	const RobotList &getRobots() const { return robots; }
 
-	double getTime() { return time; }
+	ParticleList &getParticles() { return particles; }
 
-	Position getWorldOrigin();
+	const ParticleList &getParticles() const { return particles; }
 
-	Position getWorldEnd();
+	double getTime() const { return time; }
 
-	void serialize(const std::string &outputPath, const std::string &fileName);
+	const Position &getWorldOrigin() const { return worldOrigin; }
 
-	void serialize(const std::string &outputPath);
+	const Position &getWorldEnd() const { return worldEnd; }
+
+	void serialize(const std::string &outputPath, const std::string &fileName) const;
+
+	void serialize(const std::string &outputPath, FileFormat format = JSON_PRETTY) const;
 
 	void deserialize(const std::string &fileName);
 
+	// The stream must be seekable, a pipe is read in memory first
+	void deserialize(std::istream &input);
+
 	friend std::ostream &operator<<(std::ostream &os, const State &s);
 
-	bool isEmpty() { return robots.empty() && particles.empty(); }
+	bool isEmpty() const { return robots.empty() && particles.empty(); }
 
 private:
 	double time;
 	Position worldOrigin;
 	Position worldEnd;
-	std::vector<Robot> robots;
-	std::vector<Particle> particles;
+	RobotList robots;
+	ParticleList particles;
 	std::string fileExtension = ".stat";
 
+	static std::pmr::memory_resource *snapshotPool();
+
 	NLOHMANN_DEFINE_TYPE_INTRUSIVE(State, time, worldOrigin, worldEnd, robots,
 											 particles)
 };
@@ -0,0 +1,71 @@
+/*-----------------------------------------------------------------------------
+File name : statestream.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the pull reader of the state and timeline files
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <stdexcept>
+#include "statestream.h"
+#include "saxreader.h"
+
+// Thrown through the parser to stop reading
+struct ReadingStopped {};
+
+StateStream::StateStream(const std::string &path, std::size_t capacity)
+	: input(path, std::ios::binary), capacity(std::max<std::size_t>(1, capacity)) {
+	if (!input)
+		throw std::runtime_error("Could not open '" + path + "'");
+	reader = std::thread(&StateStream::read, this);
+}
+
+StateStream::~StateStream() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopped = true;
+	}
+	changed.notify_all();
+	reader.join();
+}
+
+void StateStream::read() {
+	try {
+		readStates(input, [this](State &&state) {
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this]() { return stopped || queue.size() < capacity; });
+			if (stopped)
+				throw ReadingStopped();
+			queue.push_back(std::move(state));
+			changed.notify_all();
+		});
+	}
+	catch (ReadingStopped &) {
+		// The owner does not want more states
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(mutex);
+		error = std::current_exception();
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	finished = true;
+	changed.notify_all();
+}
+
+bool StateStream::next(State &state) {
+	std::unique_lock<std::mutex> lock(mutex);
+	changed.wait(lock, [this]() { return !queue.empty() || finished; });
+	if (!queue.empty()) {
+		state = std::move(queue.front());
+		queue.pop_front();
+		changed.notify_all();
+		return true;
+	}
+	if (error) {
+		std::exception_ptr thrown = error;
+		error = nullptr;
+		std::rethrow_exception(thrown);
+	}
+	return false;
+}
@@ -0,0 +1,60 @@
+/*-----------------------------------------------------------------------------
+File name : statestream.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the pull reader of the state and timeline files. The
+streaming reader runs on a thread of its own and hands the states over through
+a bounded queue, so that a timeline of any length is read with a few states in
+memory, and several files can be read side by side.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef STATESTREAM_H
+#define STATESTREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "state.h"
+
+const std::size_t STREAM_CAPACITY = 16; // states waiting in the queue
+
+class StateStream {
+
+public:
+	// Any format read by readStates, compressed timelines included. The reader
+	// blocks on the queue, it does not run on the task pool
+	explicit StateStream(const std::string &path,
+								std::size_t capacity = STREAM_CAPACITY);
+
+	// Stops the reader if the file was not read to the end
+	~StateStream();
+
+	StateStream(const StateStream &) = delete;
+
+	StateStream &operator=(const StateStream &) = delete;
+
+	// Next state of the file, false at the end of the file. The reading errors
+	// are thrown here
+	bool next(State &state);
+
+private:
+	std::ifstream input;
+	std::size_t capacity;
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::deque<State> queue;
+	bool finished = false;
+	bool stopped = false;
+	std::exception_ptr error;
+	std::thread reader; // started last, uses the members above
+
+	void read();
+};
+
+#endif // STATESTREAM_H
@@ -0,0 +1,50 @@
+/*-----------------------------------------------------------------------------
+File name : sweepprune.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the broad phase of the collision checks. The
+sweep stops at the first body starting after the right side of the current
+one, so a pair is only looked at when the boxes overlap along x.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <numeric>
+#include "sweepprune.h"
+
+const std::vector<SweepPair> &SweepAndPrune::update(std::span<const SweepBox> boxes) {
+	if (order.size() != boxes.size()) {
+		// Room for a pair by body, a crowd seldom has more
+		pairs.reserve(boxes.size());
+		order.resize(boxes.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+			return boxes[a].minX < boxes[b].minX;
+		});
+	} else {
+		// Almost sorted, each body only passes its close neighbours
+		for (std::size_t i = 1; i < order.size(); ++i) {
+			std::size_t body = order[i];
+			double left = boxes[body].minX;
+			std::size_t j = i;
+			for (; j > 0 && boxes[order[j - 1]].minX > left; --j)
+				order[j] = order[j - 1];
+			order[j] = body;
+		}
+	}
+
+	pairs.clear();
+	for (std::size_t i = 0; i < order.size(); ++i) {
+		const SweepBox &box = boxes[order[i]];
+		for (std::size_t j = i + 1; j < order.size(); ++j) {
+			const SweepBox &other = boxes[order[j]];
+			if (other.minX > box.maxX)
+				break;
+			if (other.minY <= box.maxY && box.minY <= other.maxY)
+				pairs.push_back(std::minmax(order[i], order[j]));
+		}
+	}
+	// The same pairs whatever the order of the previous call
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
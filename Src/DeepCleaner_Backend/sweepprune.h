@@ -0,0 +1,51 @@
+/*-----------------------------------------------------------------------------
+File name : sweepprune.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the broad phase of the collision checks. The bodies
+are kept sorted on the left side of their box, and a sweep along x finds the
+pairs of boxes overlapping on both axes. The bodies only move a little from
+one step to the next, so the order of the previous step is sorted again by
+insertion in close to linear time. Only the pairs found need an exact check.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef SWEEPPRUNE_H
+#define SWEEPPRUNE_H
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+#include "position.h"
+
+// Bounds of a body on both axes
+struct SweepBox {
+	double minX = 0.0;
+	double maxX = 0.0;
+	double minY = 0.0;
+	double maxY = 0.0;
+};
+
+// Square of the given half size around a center
+inline SweepBox boxAround(const Position &center, double halfSize) {
+	return {center.getX() - halfSize, center.getX() + halfSize,
+			  center.getY() - halfSize, center.getY() + halfSize};
+}
+
+// Indices of two bodies, the smaller one first
+using SweepPair = std::pair<std::size_t, std::size_t>;
+
+class SweepAndPrune {
+
+public:
+	// Pairs of boxes overlapping or touching, sorted. The boxes are the bodies
+	// of the previous call moved, or new ones if their number changed
+	const std::vector<SweepPair> &update(std::span<const SweepBox> boxes);
+
+private:
+	std::vector<std::size_t> order; // bodies by left side
+	std::vector<SweepPair> pairs;
+};
+
+#endif // SWEEPPRUNE_H
@@ -0,0 +1,209 @@
+/*-----------------------------------------------------------------------------
+File name : taskpool.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the work-stealing task pool
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include "taskpool.h"
+
+const std::size_t TASKS_PER_THREAD = 8; // parallelFor splitting
+
+static std::atomic<unsigned> sharedThreadCount{0};
+
+// Pool and queue of the worker running on this thread, if any
+thread_local TaskPool *currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+TaskPool::TaskPool(unsigned threads) {
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned i = 1; i < threads; ++i)
+		workers.push_back(std::make_unique<Worker>());
+	for (unsigned i = 0; i < workers.size(); ++i)
+		workers[i]->thread = std::thread(&TaskPool::workerLoop, this, i);
+}
+
+TaskPool::~TaskPool() {
+	stopping = true;
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wakeUp.notify_all();
+	for (std::unique_ptr<Worker> &worker: workers)
+		worker->thread.join();
+}
+
+TaskPool &TaskPool::shared() {
+	static TaskPool pool(sharedThreadCount);
+	return pool;
+}
+
+void TaskPool::setSharedThreadCount(unsigned threads) {
+	sharedThreadCount = threads;
+}
+
+std::pmr::memory_resource *TaskPool::threadArena() {
+	thread_local std::pmr::unsynchronized_pool_resource arena;
+	return &arena;
+}
+
+void TaskPool::submit(Task task) {
+	if (workers.empty()) {
+		task();
+		return;
+	}
+
+	// A worker keeps its tasks, the other threads spread them
+	unsigned index = currentPool == this ? unsigned(currentWorker)
+													 : nextQueue++ % workers.size();
+	{
+		std::lock_guard<std::mutex> lock(workers[index]->mutex);
+		workers[index]->tasks.push_back(std::move(task));
+		++queued;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wakeUp.notify_one();
+}
+
+bool TaskPool::popOwn(Task &task) {
+	if (currentPool != this)
+		return false;
+	Worker &worker = *workers[currentWorker];
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	if (worker.tasks.empty())
+		return false;
+	// Newest first, its data is still in the cache
+	task = std::move(worker.tasks.back());
+	worker.tasks.pop_back();
+	--queued;
+	return true;
+}
+
+bool TaskPool::steal(Task &task) {
+	unsigned count = unsigned(workers.size());
+	unsigned first = currentPool == this ? unsigned(currentWorker) + 1 : 0;
+	for (unsigned i = 0; i < count; ++i) {
+		Worker &victim = *workers[(first + i) % count];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (victim.tasks.empty())
+			continue;
+		// Oldest first, usually the biggest part of a split range
+		task = std::move(victim.tasks.front());
+		victim.tasks.pop_front();
+		--queued;
+		return true;
+	}
+	return false;
+}
+
+bool TaskPool::runOne() {
+	Task task;
+	if (!popOwn(task) && !steal(task))
+		return false;
+	task();
+	return true;
+}
+
+void TaskPool::workerLoop(unsigned index) {
+	currentPool = this;
+	currentWorker = int(index);
+	while (true) {
+		if (runOne())
+			continue;
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeUp.wait(lock, [this]() { return stopping || queued > 0; });
+		if (stopping && queued == 0)
+			return;
+	}
+}
+
+void TaskPool::parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+									const std::function<void(std::size_t, std::size_t)> &body) {
+	if (end <= begin)
+		return;
+	grain = std::max<std::size_t>(1, grain);
+	if (workers.empty() || end - begin <= grain) {
+		body(begin, end);
+		return;
+	}
+
+	// Halves are handed to the pool until they are small enough
+	TaskGroup group(*this);
+	std::function<void(std::size_t, std::size_t)> split =
+		[&](std::size_t first, std::size_t last) {
+			while (last - first > grain) {
+				std::size_t middle = first + (last - first) / 2;
+				group.run([&split, middle, last]() { split(middle, last); });
+				last = middle;
+			}
+			body(first, last);
+		};
+	split(begin, end);
+	group.wait();
+}
+
+void TaskPool::parallelFor(std::size_t count,
+									const std::function<void(std::size_t)> &body) {
+	std::size_t grain = count / (getThreadCount() * TASKS_PER_THREAD);
+	parallelFor(0, count, grain, [&body](std::size_t first, std::size_t last) {
+		for (std::size_t i = first; i < last; ++i)
+			body(i);
+	});
+}
+
+TaskGroup::~TaskGroup() {
+	try {
+		wait();
+	}
+	catch (...) {
+		// Only wait() reports the errors
+	}
+}
+
+void TaskGroup::run(Task task) {
+	++pending;
+	pool.submit([this, task = std::move(task)]() {
+		try {
+			task();
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error)
+				error = std::current_exception();
+		}
+		// Last access to the group, the waiting thread may destroy it once the
+		// lock is released. It checks pending under the lock, so it cannot miss
+		// the wake up
+		TaskPool &owner = pool;
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(owner.sleepMutex);
+			done = pending.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+		if (done)
+			owner.wakeUp.notify_all();
+	});
+}
+
+void TaskGroup::wait() {
+	// Help the pool, then sleep until a task is queued or the group is done
+	while (pending.load(std::memory_order_acquire) > 0) {
+		if (pool.runOne())
+			continue;
+		std::unique_lock<std::mutex> lock(pool.sleepMutex);
+		pool.wakeUp.wait(lock, [this]() {
+			return pending.load(std::memory_order_acquire) == 0 || pool.queued > 0;
+		});
+	}
+	std::lock_guard<std::mutex> lock(errorMutex);
+	if (error) {
+		std::exception_ptr thrown = error;
+		error = nullptr;
+		std::rethrow_exception(thrown);
+	}
+}
@@ -0,0 +1,117 @@
+/*-----------------------------------------------------------------------------
+File name : taskpool.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the work-stealing task pool, the single place where
+the Backend gets its threads from. Every worker runs the tasks of its own
+queue from the back and steals the oldest tasks of the others when it is
+empty. A thread waiting for a task group runs tasks instead of blocking, so
+task groups and parallel loops can be nested, and sleeps only when no task is
+queued, until one is or its group is done.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Task = std::function<void()>;
+
+class TaskPool {
+
+public:
+	// 0 threads uses the number of cores, the thread waiting on a task group
+	// counts as one
+	explicit TaskPool(unsigned threads = 0);
+
+	~TaskPool();
+
+	TaskPool(const TaskPool &) = delete;
+
+	TaskPool &operator=(const TaskPool &) = delete;
+
+	unsigned getThreadCount() const { return unsigned(workers.size()) + 1; }
+
+	// Pool of the program, created with setSharedThreadCount threads on first use
+	static TaskPool &shared();
+
+	// Must be called before the first use of the shared pool
+	static void setSharedThreadCount(unsigned threads);
+
+	// Call body(first, last) on sub-ranges of [begin, end) of at most grain
+	// indices, and wait for all of them
+	void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+						  const std::function<void(std::size_t, std::size_t)> &body);
+
+	// Call body(i) for every i in [0, count)
+	void parallelFor(std::size_t count, const std::function<void(std::size_t)> &body);
+
+	// Memory of the calling thread, never shared with another thread so that the
+	// allocations take no lock. The blocks freed are kept for the next tasks of
+	// the thread, and released when it ends
+	static std::pmr::memory_resource *threadArena();
+
+private:
+	friend class TaskGroup;
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::mutex sleepMutex;
+	std::condition_variable wakeUp; // a task was queued or a task group is done
+	std::atomic<unsigned> queued{0}; // tasks waiting in the queues
+	std::atomic<unsigned> nextQueue{0};
+	std::atomic<bool> stopping{false};
+
+	void submit(Task task);
+
+	// Run one queued task, false if there was none
+	bool runOne();
+
+	bool popOwn(Task &task);
+
+	bool steal(Task &task);
+
+	void workerLoop(unsigned index);
+};
+
+// Set of tasks waited for together. The first exception thrown by a task is
+// thrown again by wait
+class TaskGroup {
+
+public:
+	explicit TaskGroup(TaskPool &pool = TaskPool::shared()) : pool(pool) {}
+
+	~TaskGroup();
+
+	TaskGroup(const TaskGroup &) = delete;
+
+	TaskGroup &operator=(const TaskGroup &) = delete;
+
+	void run(Task task);
+
+	void wait();
+
+private:
+	TaskPool &pool;
+	std::atomic<std::size_t> pending{0};
+	std::mutex errorMutex;
+	std::exception_ptr error;
+};
+
+#endif // TASKPOOL_H
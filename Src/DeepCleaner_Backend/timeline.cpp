@@ -6,10 +6,14 @@ Description :  Implementation of the timeline class
 Compiler : Mingw-w64 g++ 11.2.0
 -----------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include "timeline.h"
 #include "utils.h"
+#include "saxreader.h"
+#include "trajectory.h"
 
 Timeline::Timeline(constStr &path){
     try{
@@ -36,30 +40,53 @@ void Timeline::serialize(constStr &outputPath, constStr &fileName){
     serialize(outputPath + addExtension(fileName, ".tlin"));
 }
 
-void Timeline::serialize(constStr &outputPath){
+void Timeline::serialize(constStr &outputPath, FileFormat format){
     std::ofstream ofs;
     json tl_j = *this;
     try{
-        ofs.open (outputPath);
+        ofs.open(outputPath, isBinaryFormat(format) ?
+                 std::ios::out | std::ios::binary : std::ios::out);
     }
     catch (std::ios_base::failure &e){
         throw "Error creating the file \'" + outputPath + "\' : " + e.what();
     }
-    ofs << std::setw(4) << tl_j;
+    writeDocument(ofs, tl_j, format);
     ofs.close();
 }
 
+void Timeline::serialize(std::ostream &output, FileFormat format){
+    json tl_j = *this;
+    writeDocument(output, tl_j, format);
+}
+
+void Timeline::serializeBlocks(constStr &outputPath, BlockCodec codec,
+                               unsigned statesPerBlock) const {
+    std::ofstream ofs(outputPath, std::ios::out | std::ios::binary);
+    if (!ofs)
+        throw std::runtime_error("Error creating the file '" + outputPath + "'");
+    serializeBlocks(ofs, codec, statesPerBlock);
+}
+
+void Timeline::serializeBlocks(std::ostream &output, BlockCodec codec,
+                               unsigned statesPerBlock) const {
+    writeBlocks(output, states, codec, statesPerBlock);
+}
+
 void Timeline::deserialize(constStr &inputPath){
-    std::ifstream f(inputPath);
-    json data = json::parse(f);
-    this->states = data.get<Timeline>().states;
+    std::ifstream f(inputPath, std::ios::binary);
+    deserialize(f);
+}
+
+void Timeline::deserialize(std::istream &input){
+    this->states.clear();
+    readStates(input, [this](State &&s) { this->states.push_back(std::move(s)); });
 }
 
 void Timeline::setCurrentState(double time) {
 	if (!this->isEmpty()) {
 		// Search the state before the first one with time bigger than the actual time
-		StateIterator newState = std::prev(std::find_if(states.begin(), states.end
-			(), [=](State s) { return s.getTime() > time; }), 1);
+		StateIterator newState = std::prev(std::upper_bound(states.begin(), states.end
+			(), time, [](double t, const State &s) { return t < s.getTime(); }), 1);
 
 		// Update the current state
 		if (newState != currentState) {
@@ -68,6 +95,71 @@ void Timeline::setCurrentState(double time) {
 	}
 }
 
+std::size_t Timeline::getStateIndex(double time) const {
+    auto next = std::upper_bound(states.begin(), states.end(), time,
+                                 [](double t, const State &s) {
+                                     return t < s.getTime();
+                                 });
+    return next == states.begin() ? 0 : std::size_t(next - states.begin() - 1);
+}
+
+// True if the robots of state are the ones of previous moved to its time and
+// no particle changed
+static bool isReproducible(const State &previous, const State &state,
+                           double tolerance) {
+    const RobotList &robotsBefore = previous.getRobots();
+    const RobotList &robots = state.getRobots();
+    const ParticleList &particlesBefore = previous.getParticles();
+    const ParticleList &particles = state.getParticles();
+    if (robots.size() != robotsBefore.size() ||
+        particles.size() != particlesBefore.size())
+        return false;
+
+    double deltaTime = state.getTime() - previous.getTime();
+    for (std::size_t i = 0; i < robots.size(); ++i) {
+        const Robot &r = robots[i];
+        Robot expected = robotsBefore[i].movedFor(deltaTime);
+        if (r.getId() != expected.getId() ||
+            std::abs(r.getLeftSpeed() - expected.getLeftSpeed()) > tolerance ||
+            std::abs(r.getRightSpeed() - expected.getRightSpeed()) > tolerance ||
+            std::abs(r.getScore() - expected.getScore()) > tolerance ||
+            linearDistance(r.getPosition(), expected.getPosition()) > tolerance ||
+            std::abs(std::remainder(r.getAngle(DEG) - expected.getAngle(DEG), 360.0))
+            > tolerance)
+            return false;
+    }
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        const Particle &p = particles[i];
+        const Particle &before = particlesBefore[i];
+        if (p.getId() != before.getId() ||
+            linearDistance(p.getPosition(), before.getPosition()) > tolerance ||
+            std::abs(p.getRadius() - before.getRadius()) > tolerance)
+            return false;
+    }
+    return true;
+}
+
+std::size_t Timeline::compact(double tolerance) {
+    std::size_t count = states.size();
+    if (count <= 2)
+        return 0;
+
+    // kept is the last state written, the next ones are compared to it
+    std::size_t kept = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        bool last = i == count - 1;
+        if (states[i].getTime() == states[kept].getTime() && kept != 0)
+            states[kept] = std::move(states[i]);
+        else if (last || !isReproducible(states[kept], states[i], tolerance)) {
+            if (++kept != i)
+                states[kept] = std::move(states[i]);
+        }
+    }
+    states.erase(states.begin() + std::ptrdiff_t(kept + 1), states.end());
+    setLastState();
+    return count - states.size();
+}
+
 void Timeline::setFirstState(){
     currentState = states.begin();
 }
@@ -111,17 +203,27 @@ void Timeline::addState(const State &state){
    this->states.push_back(state);
 }
 
+void Timeline::addState(State &&state){
+   this->states.push_back(std::move(state));
+}
+
 void Timeline::addAndSetState(const State &state){
     addState(state);
     setLastState();
 }
 
+void Timeline::addAndSetState(State &&state){
+    addState(std::move(state));
+    setLastState();
+}
+
 Constraints Timeline::deserializeConstraints(const std::string &fileName) {
     std::ifstream f(fileName);
-    json data = json::parse(f);
-    std::cout << data << '\n';
-    this->constraints.commandTimeInterval = data.get<Constraints>().commandTimeInterval;
-    this->constraints.maxForwardSpeed = data.get<Constraints>().maxForwardSpeed;
-    this->constraints.maxBackwardSpeed = data.get<Constraints>().maxBackwardSpeed;
+    return deserializeConstraints(f);
+}
+
+Constraints Timeline::deserializeConstraints(std::istream &input) {
+    json data = json::parse(input);
+    this->constraints = data.get<Constraints>();
     return this->constraints;
 }
\ No newline at end of file
@@ -9,15 +9,20 @@ Compiler : Mingw-w64 g++ 11.2.0
 #ifndef TIMELINE_H
 #define TIMELINE_H
 
+#include <span>
 #include <vector>
 #include <string>
 #include "state.h"
 #include "json.hpp"
+#include "fileformat.h"
+#include "blockfile.h"
 
 using json = nlohmann::json;
 using StateIterator = std::vector<State>::iterator;
 using constStr = const std::string;
 
+const double COMPACT_TOLERANCE = 1e-6;
+
 struct Constraints {
     double commandTimeInterval = 1.0;
     double maxBackwardSpeed = 5.0;
@@ -49,8 +54,12 @@ public:
 
     void addState(const State &state);
 
+    void addState(State &&state);
+
     void addAndSetState(const State &state);
 
+    void addAndSetState(State &&state);
+
     State *getCurrentState() const;
 
     State *getNextState() const;
@@ -71,17 +80,43 @@ public:
         return state == (states.begin());
     }
 
-    bool isEmpty() { return states.empty(); }
+    bool isEmpty() const { return states.empty(); }
+
+    std::span<const State> getStates() const { return states; }
+
+    // Index of the state displayed at the given time
+    std::size_t getStateIndex(double time) const;
+
+    // Remove the states that the previous one gives by moving its robots with
+    // their wheel speeds, within the tolerance, and keep only the last state
+    // of a time. The first and the last states are kept. Return the number of
+    // states removed
+    std::size_t compact(double tolerance = COMPACT_TOLERANCE);
 
     void serialize(constStr &outputPath, constStr &fileName);
 
-    void serialize(constStr &outputPath);
+    void serialize(constStr &outputPath, FileFormat format = JSON_PRETTY);
+
+    void serialize(std::ostream &output, FileFormat format = JSON_PRETTY);
+
+    // Compressed timeline, cut in independent blocks of states
+    void serializeBlocks(constStr &outputPath, BlockCodec codec,
+                         unsigned statesPerBlock = STATES_PER_BLOCK) const;
+
+    // The stream must be seekable, the index is written after the blocks
+    void serializeBlocks(std::ostream &output, BlockCodec codec,
+                         unsigned statesPerBlock = STATES_PER_BLOCK) const;
 
     void deserialize(constStr &inputPath);
 
+    // The stream must be seekable, a pipe is read in memory first
+    void deserialize(std::istream &input);
+
     Constraints deserializeConstraints(const std::string &fileName);
 
-    Constraints getConstraints(){return this->constraints;}
+    Constraints deserializeConstraints(std::istream &input);
+
+    const Constraints &getConstraints() const {return this->constraints;}
 
 private:
     Constraints constraints;
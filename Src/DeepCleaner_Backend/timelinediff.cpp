@@ -0,0 +1,253 @@
+/*-----------------------------------------------------------------------------
+File name : timelinediff.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Program that compares two timelines generated from the same base
+ state and reports where they diverge. Both files are streamed side by side and
+ compared at every time where one of them has a state. A timeline only holds a
+ state when a robot gets a new command, so the robots of the other timeline are
+ moved to that time with their wheel speeds before being compared.
+
+Command line arguments: DeepCleaner_Diff <Timeline A> <Timeline B>
+ [-e <Tolerance>]
+Exit code: 0 if the timelines are the same, 1 if they differ, 2 on error
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "state.h"
+#include "statestream.h"
+#include "trajectory.h"
+
+using namespace std;
+const int SAME = 0, DIFFERENT = 1, DIFF_ERROR = 2;
+const double DEFAULT_TOLERANCE = 1e-6;
+const char TOLERANCE_ARG = 'e';
+
+struct RobotDelta {
+    int id;
+    bool missing = false; // robot in one timeline only
+    double distance = 0;  // position (pixels)
+    double angle = 0;     // degrees, in [-180, 180]
+    double score = 0;     // B - A
+};
+
+struct StateDiff {
+    vector<RobotDelta> robots; // only the robots that differ
+    vector<int> onlyInA, onlyInB, changed; // particle ids
+    double scoreA = 0, scoreB = 0;
+
+    bool differs() const {
+        return !robots.empty() || !onlyInA.empty() || !onlyInB.empty() ||
+               !changed.empty();
+    }
+};
+
+// Worst difference of one robot over the whole timelines
+struct RobotSummary {
+    double distance = 0;
+    double angle = 0;
+    double firstTime = -1; // time of its first difference
+};
+
+void showHelp();
+
+StateDiff compareStates(const State &a, const State &b, double time,
+                        double tolerance);
+
+void printIds(const string &title, const vector<int> &ids);
+
+void printDiff(const StateDiff &diff, double time, size_t indexA, size_t indexB);
+
+int main(int argc, char *argv[]) {
+    vector<string> files;
+    double tolerance = DEFAULT_TOLERANCE;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.size() == 2 && arg[0] == '-' && arg[1] == TOLERANCE_ARG &&
+            i + 1 < argc) {
+            try {
+                tolerance = stod(argv[++i]);
+            }
+            catch (exception &) {
+                cerr << "Invalid tolerance '" << argv[i] << "'\n";
+                return DIFF_ERROR;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            showHelp();
+            return DIFF_ERROR;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() != 2) {
+        showHelp();
+        return DIFF_ERROR;
+    }
+
+    try {
+        StateStream streamA(files[0]), streamB(files[1]);
+        State a, b, nextA, nextB;
+        if (!streamA.next(a) || !streamB.next(b))
+            throw runtime_error("Empty timeline");
+        bool hasNextA = streamA.next(nextA), hasNextB = streamB.next(nextB);
+        size_t indexA = 0, indexB = 0;
+
+        bool diverged = false;
+        size_t compared = 0, differing = 0;
+        map<int, RobotSummary> summaries;
+        StateDiff last;
+        while (true) {
+            // Compared when the most recent of the two states is displayed
+            double time = max(a.getTime(), b.getTime());
+            StateDiff diff = compareStates(a, b, time, tolerance);
+            ++compared;
+            if (diff.differs()) {
+                ++differing;
+                if (!diverged) {
+                    printDiff(diff, time, indexA, indexB);
+                    diverged = true;
+                }
+                for (const RobotDelta &d: diff.robots) {
+                    RobotSummary &s = summaries[d.id];
+                    s.distance = max(s.distance, d.distance);
+                    s.angle = max(s.angle, abs(d.angle));
+                    if (s.firstTime < 0)
+                        s.firstTime = time;
+                }
+            }
+            last = std::move(diff);
+
+            if (!hasNextA && !hasNextB)
+                break;
+            double timeA = hasNextA ? nextA.getTime() : numeric_limits<double>::max();
+            double timeB = hasNextB ? nextB.getTime() : numeric_limits<double>::max();
+            double nextTime = min(timeA, timeB);
+            if (timeA == nextTime) {
+                a = std::move(nextA);
+                hasNextA = streamA.next(nextA);
+                ++indexA;
+            }
+            if (timeB == nextTime) {
+                b = std::move(nextB);
+                hasNextB = streamB.next(nextB);
+                ++indexB;
+            }
+        }
+
+        if (!diverged) {
+            cout << "The timelines are the same (" << compared << " times compared, "
+                 << indexA + 1 << " states)\n";
+            return SAME;
+        }
+        cout << "\nDifferent at " << differing << " of " << compared
+             << " compared times\n";
+        for (const auto &[id, s]: summaries)
+            cout << "Robot " << id << " : first difference at " << s.firstTime
+                 << " sec, max position delta " << s.distance
+                 << " px, max angle delta " << s.angle << " deg\n";
+        cout << "States : A " << indexA + 1 << " ending at " << a.getTime()
+             << " sec, B " << indexB + 1 << " ending at " << b.getTime() << " sec\n";
+        cout << "Final score : A " << last.scoreA << ", B " << last.scoreB
+             << ", delta " << last.scoreB - last.scoreA << '\n';
+        return DIFFERENT;
+    }
+    catch (exception &e) {
+        cerr << "Exception occurred : " << e.what() << '\n';
+        return DIFF_ERROR;
+    }
+}
+
+void showHelp() {
+    cout << "Usage : DeepCleaner_Diff <Timeline A> <Timeline B> [-"
+         << TOLERANCE_ARG << " <Tolerance>]\n"
+         << "Compares two timelines and reports where they diverge\n"
+         << " -" << TOLERANCE_ARG << " : largest difference ignored (default "
+         << DEFAULT_TOLERANCE << ")\n";
+}
+
+StateDiff compareStates(const State &a, const State &b, double time,
+                        double tolerance) {
+    StateDiff diff;
+    map<int, const Robot *> robotsB;
+    for (const Robot &r: b.getRobots()) {
+        robotsB[r.getId()] = &r;
+        diff.scoreB += r.getScore();
+    }
+    for (const Robot &r: a.getRobots()) {
+        diff.scoreA += r.getScore();
+        auto found = robotsB.find(r.getId());
+        if (found == robotsB.end()) {
+            diff.robots.push_back({r.getId(), true});
+            continue;
+        }
+        Robot ra = r.movedFor(time - a.getTime());
+        Robot rb = found->second->movedFor(time - b.getTime());
+        robotsB.erase(found);
+
+        RobotDelta d{r.getId()};
+        d.distance = linearDistance(ra.getPosition(), rb.getPosition());
+        d.angle = remainder(rb.getAngle(DEG) - ra.getAngle(DEG), 360.0);
+        d.score = rb.getScore() - ra.getScore();
+        if (d.distance > tolerance || abs(d.angle) > tolerance ||
+            abs(d.score) > tolerance)
+            diff.robots.push_back(d);
+    }
+    for (const auto &[id, r]: robotsB)
+        diff.robots.push_back({id, true});
+
+    map<int, const Particle *> particlesB;
+    for (const Particle &p: b.getParticles())
+        particlesB[p.getId()] = &p;
+    for (const Particle &p: a.getParticles()) {
+        auto found = particlesB.find(p.getId());
+        if (found == particlesB.end()) {
+            diff.onlyInA.push_back(p.getId());
+            continue;
+        }
+        const Particle &pb = *found->second;
+        if (linearDistance(p.getPosition(), pb.getPosition()) > tolerance ||
+            abs(p.getRadius() - pb.getRadius()) > tolerance)
+            diff.changed.push_back(p.getId());
+        particlesB.erase(found);
+    }
+    for (const auto &[id, p]: particlesB)
+        diff.onlyInB.push_back(id);
+    sort(diff.onlyInA.begin(), diff.onlyInA.end());
+    sort(diff.changed.begin(), diff.changed.end());
+    return diff;
+}
+
+void printIds(const string &title, const vector<int> &ids) {
+    if (ids.empty())
+        return;
+    cout << title << " :";
+    for (int id: ids)
+        cout << ' ' << id;
+    cout << '\n';
+}
+
+void printDiff(const StateDiff &diff, double time, size_t indexA, size_t indexB) {
+    cout << "First divergence at " << time << " sec (state " << indexA
+         << " of A, state " << indexB << " of B)\n";
+    for (const RobotDelta &d: diff.robots) {
+        if (d.missing) {
+            cout << "Robot " << d.id << " : in one timeline only\n";
+            continue;
+        }
+        cout << "Robot " << d.id << " : position delta " << d.distance
+             << " px, angle delta " << d.angle << " deg, score delta " << d.score
+             << '\n';
+    }
+    printIds("Particles only in A", diff.onlyInA);
+    printIds("Particles only in B", diff.onlyInB);
+    printIds("Particles moved or resized", diff.changed);
+    cout << "Score : A " << diff.scoreA << ", B " << diff.scoreB << ", delta "
+         << diff.scoreB - diff.scoreA << '\n';
+}
@@ -0,0 +1,227 @@
+/*-----------------------------------------------------------------------------
+File name : timelineindex.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the query layer of a timeline. The events are
+deduced from the differences between two consecutive states : a particle that
+disappears was eaten by the nearest robot whose score increased, or exploded
+if no score changed.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include "timelineindex.h"
+#include "trajectory.h"
+
+static bool samePose(const RobotSample &a, const RobotSample &b) {
+	return a.position.getX() == b.position.getX() &&
+			 a.position.getY() == b.position.getY() && a.angle == b.angle &&
+			 a.leftSpeed == b.leftSpeed && a.rightSpeed == b.rightSpeed &&
+			 a.score == b.score;
+}
+
+static std::vector<const Particle *> sortedById(const ParticleList &list) {
+	std::vector<const Particle *> sorted;
+	sorted.reserve(list.size());
+	for (const Particle &p: list)
+		sorted.push_back(&p);
+	std::sort(sorted.begin(), sorted.end(), [](const Particle *a, const Particle *b) {
+		return a->getId() < b->getId();
+	});
+	return sorted;
+}
+
+TimelineIndex::TimelineIndex(std::span<const State> states) {
+	std::vector<std::pair<int, int>> contacts;
+	for (std::size_t i = 0; i < states.size(); ++i) {
+		// The particles of the first state all appear at its time
+		addParticleChanges(i == 0 ? State() : states[i - 1], states[i]);
+		addRobotCollisions(states[i], contacts);
+		addRobotSamples(states[i]);
+	}
+}
+
+void TimelineIndex::addParticleChanges(const State &previous, const State &state) {
+	std::vector<const Particle *> before = sortedById(previous.getParticles());
+	std::vector<const Particle *> after = sortedById(state.getParticles());
+	auto byId = [](const Particle *a, const Particle *b) {
+		return a->getId() < b->getId();
+	};
+	std::vector<const Particle *> removed, added;
+	std::set_difference(before.begin(), before.end(), after.begin(), after.end(),
+							  std::back_inserter(removed), byId);
+	std::set_difference(after.begin(), after.end(), before.begin(), before.end(),
+							  std::back_inserter(added), byId);
+
+	double time = state.getTime();
+	std::vector<const Particle *> exploded;
+	for (const Particle *p: removed) {
+		// Robots histories still end with their previous sample
+		const Robot *eater = nullptr;
+		double eaterDistance = 0.0;
+		for (const Robot &r: state.getRobots()) {
+			auto history = robots.find(r.getId());
+			if (history == robots.end() || history->second.empty() ||
+				 r.getScore() <= history->second.back().score)
+				continue;
+			double distance = linearDistance(r.getPosition(), p->getPosition());
+			if (eater == nullptr || distance < eaterDistance) {
+				eater = &r;
+				eaterDistance = distance;
+			}
+		}
+
+		ParticleLifetime &lifetime = particles[p->getId()].back();
+		lifetime.death = time;
+		if (eater != nullptr) {
+			lifetime.eatenBy = eater->getId();
+			events.push_back({time, PARTICLE_EATEN, eater->getId(), p->getId()});
+		} else {
+			exploded.push_back(p);
+			events.push_back({time, PARTICLE_EXPLODED, -1, p->getId()});
+		}
+	}
+
+	for (const Particle *p: added) {
+		ParticleLifetime &lifetime = particles[p->getId()].emplace_back();
+		lifetime.id = p->getId();
+		lifetime.position = p->getPosition();
+		lifetime.radius = p->getRadius();
+		lifetime.birth = time;
+		// The children are placed around the center of their parent
+		double parentDistance = 0.0;
+		for (const Particle *parent: exploded) {
+			double distance = linearDistance(p->getPosition(), parent->getPosition());
+			if (lifetime.parentId == -1 || distance < parentDistance) {
+				lifetime.parentId = parent->getId();
+				parentDistance = distance;
+			}
+		}
+	}
+}
+
+void TimelineIndex::addRobotCollisions(const State &state,
+													std::vector<std::pair<int, int>> &contacts) {
+	const RobotList &list = state.getRobots();
+	std::vector<std::pair<int, int>> current;
+	for (std::size_t i = 0; i < list.size(); ++i) {
+		for (std::size_t j = i + 1; j < list.size(); ++j) {
+			if (detectCollision(list[i].getPosition(), list[i].getRadius(),
+									  list[j].getPosition(), list[j].getRadius(),
+									  COLLISION_EPSILON))
+				current.emplace_back(std::min(list[i].getId(), list[j].getId()),
+											std::max(list[i].getId(), list[j].getId()));
+		}
+	}
+	std::sort(current.begin(), current.end());
+
+	// Only the contacts that were not there in the previous state
+	for (const std::pair<int, int> &contact: current) {
+		if (!std::binary_search(contacts.begin(), contacts.end(), contact))
+			events.push_back({state.getTime(), ROBOT_COLLISION, contact.first,
+									contact.second});
+	}
+	contacts = std::move(current);
+}
+
+void TimelineIndex::addRobotSamples(const State &state) {
+	for (const Robot &r: state.getRobots()) {
+		RobotSample sample;
+		sample.time = state.getTime();
+		sample.position = r.getPosition();
+		sample.angle = r.getAngle(DEG);
+		sample.leftSpeed = r.getLeftSpeed();
+		sample.rightSpeed = r.getRightSpeed();
+		sample.score = r.getScore();
+
+		std::vector<RobotSample> &history = robots[r.getId()];
+		if (!history.empty()) {
+			const RobotSample &last = history.back();
+			if (samePose(last, sample))
+				continue;
+			if (last.leftSpeed != sample.leftSpeed ||
+				 last.rightSpeed != sample.rightSpeed)
+				events.push_back({sample.time, COMMAND_SENT, r.getId(), -1});
+		}
+		history.push_back(sample);
+	}
+}
+
+std::vector<int> TimelineIndex::getRobotIds() const {
+	std::vector<int> ids;
+	for (const auto &[id, history]: robots)
+		ids.push_back(id);
+	return ids;
+}
+
+std::span<const RobotSample> TimelineIndex::getRobotHistory(int robotId,
+																				double from,
+																				double to) const {
+	auto found = robots.find(robotId);
+	if (found == robots.end() || to < from)
+		return {};
+	const std::vector<RobotSample> &history = found->second;
+	auto after = [](double t, const RobotSample &s) { return t < s.time; };
+	auto first = std::upper_bound(history.begin(), history.end(), from, after);
+	if (first != history.begin())
+		--first;
+	auto last = std::upper_bound(first, history.end(), to, after);
+	return {first, last};
+}
+
+const RobotSample *TimelineIndex::getRobotAt(int robotId, double time) const {
+	auto found = robots.find(robotId);
+	if (found == robots.end())
+		return nullptr;
+	const std::vector<RobotSample> &history = found->second;
+	auto next = std::upper_bound(history.begin(), history.end(), time,
+										  [](double t, const RobotSample &s) {
+											  return t < s.time;
+										  });
+	return next == history.begin() ? nullptr : &*(next - 1);
+}
+
+std::span<const ParticleLifetime>
+TimelineIndex::getParticleLifetimes(int particleId) const {
+	auto found = particles.find(particleId);
+	if (found == particles.end())
+		return {};
+	return found->second;
+}
+
+const ParticleLifetime *TimelineIndex::getParticleAt(int particleId,
+																	  double time) const {
+	std::span<const ParticleLifetime> lifetimes = getParticleLifetimes(particleId);
+	auto next = std::upper_bound(lifetimes.begin(), lifetimes.end(), time,
+										  [](double t, const ParticleLifetime &l) {
+											  return t < l.birth;
+										  });
+	if (next == lifetimes.begin() || time >= (next - 1)->death)
+		return nullptr;
+	return &*(next - 1);
+}
+
+std::span<const TimelineEvent> TimelineIndex::getEvents(double from,
+																		  double to) const {
+	if (to < from)
+		return {};
+	auto first = std::lower_bound(events.begin(), events.end(), from,
+											[](const TimelineEvent &e, double t) {
+												return e.time < t;
+											});
+	auto last = std::upper_bound(first, events.end(), to,
+										  [](double t, const TimelineEvent &e) {
+											  return t < e.time;
+										  });
+	return {first, last};
+}
+
+std::vector<TimelineEvent> TimelineIndex::getEvents(TimelineEventType type,
+																	 double from, double to) const {
+	std::vector<TimelineEvent> found;
+	for (const TimelineEvent &e: getEvents(from, to)) {
+		if (e.type == type)
+			found.push_back(e);
+	}
+	return found;
+}
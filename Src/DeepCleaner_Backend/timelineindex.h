@@ -0,0 +1,107 @@
+/*-----------------------------------------------------------------------------
+File name : timelineindex.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the query layer of a timeline. The index is built once
+from the states and keeps per-object histories, the lifetime of every particle
+and the events found between consecutive states, so that the queries are
+binary searches and never go through the states again.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef TIMELINEINDEX_H
+#define TIMELINEINDEX_H
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+#include "state.h"
+#include "position.h"
+
+typedef enum {
+	COMMAND_SENT,      // the wheel speeds of a robot changed
+	PARTICLE_EATEN,    // a robot touched a particle and scored its area
+	PARTICLE_EXPLODED, // a particle disappeared without being eaten
+	ROBOT_COLLISION    // two robots started to touch each other
+} TimelineEventType;
+
+struct TimelineEvent {
+	double time = 0.0;
+	TimelineEventType type = COMMAND_SENT;
+	int robotId = -1; // robot concerned, -1 for an explosion
+	int otherId = -1; // particle eaten or exploded, other robot of a collision
+};
+
+// Robot as displayed from its time until the next sample
+struct RobotSample {
+	double time = 0.0;
+	Position position;
+	double angle = 0.0; // degrees
+	double leftSpeed = 0.0;
+	double rightSpeed = 0.0;
+	double score = 0.0;
+};
+
+struct ParticleLifetime {
+	int id = -1;
+	Position position;
+	double radius = 0.0;
+	double birth = 0.0;
+	double death = std::numeric_limits<double>::infinity(); // never removed
+	int parentId = -1; // particle whose explosion created this one
+	int eatenBy = -1;  // robot id, -1 if it exploded or was never removed
+};
+
+class TimelineIndex {
+
+public:
+	// The states are read once, they are not kept by the index
+	explicit TimelineIndex(std::span<const State> states);
+
+	std::vector<int> getRobotIds() const;
+
+	// Samples of the robot displayed in [from, to], starting with the one
+	// displayed at from. Empty for an unknown robot
+	std::span<const RobotSample> getRobotHistory(int robotId, double from,
+																double to) const;
+
+	// nullptr for an unknown robot or a time before the first state
+	const RobotSample *getRobotAt(int robotId, double time) const;
+
+	// Lifetimes of the particles that had this id, ordered by birth. The
+	// simulation gives the id of a removed particle to a new one, usually there
+	// is a single lifetime. Empty for an unknown particle
+	std::span<const ParticleLifetime> getParticleLifetimes(int particleId) const;
+
+	// nullptr if no particle had this id at the given time
+	const ParticleLifetime *getParticleAt(int particleId, double time) const;
+
+	const std::map<int, std::vector<ParticleLifetime>> &getParticles() const {
+		return particles;
+	}
+
+	// Events in [from, to], ordered by time
+	std::span<const TimelineEvent> getEvents(double from, double to) const;
+
+	std::span<const TimelineEvent> getEvents() const { return events; }
+
+	std::vector<TimelineEvent> getEvents(TimelineEventType type, double from,
+													 double to) const;
+
+private:
+	std::map<int, std::vector<RobotSample>> robots;
+	std::map<int, std::vector<ParticleLifetime>> particles;
+	std::vector<TimelineEvent> events;
+
+	void addRobotSamples(const State &state);
+
+	void addParticleChanges(const State &previous, const State &state);
+
+	void addRobotCollisions(const State &state,
+									std::vector<std::pair<int, int>> &contacts);
+};
+
+#endif // TIMELINEINDEX_H
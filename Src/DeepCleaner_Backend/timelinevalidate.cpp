@@ -0,0 +1,165 @@
+/*-----------------------------------------------------------------------------
+File name : timelinevalidate.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Program that checks that a timeline follows the rules of the
+ robots : speed limits, command times, collisions and decontamination. Meant to
+ run after every batch of generated timelines.
+
+Command line arguments: DeepCleaner_Validate <Timeline> <Constraints>
+ [-e <Tolerance>] [-j <Threads>] [-p <Frames per second>] [-x <Time mode>]
+Exit code: 0 if the timeline is valid, 1 if a rule is broken, 2 on error
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "timeline.h"
+#include "taskpool.h"
+#include "validator.h"
+
+using namespace std;
+const int VALID = 0, INVALID = 1, VALIDATION_ERROR = 2;
+const size_t MAX_REPORTED = 20; // violations printed per type
+const char TOLERANCE_ARG = 'e', THREADS_ARG = 'j', FPS_ARG = 'p', TIME_ARG = 'x';
+
+void showHelp();
+
+void printViolation(const Violation &v);
+
+int main(int argc, char *argv[]) {
+    vector<string> files;
+    double tolerance = VALIDATION_TOLERANCE;
+    unsigned threads = 0;
+    // The configuration of the engine that made the timeline
+    int framePerSec = DefaultSimConfig::framePerSec;
+    bool exact = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc && arg[1] == TIME_ARG) {
+            string mode = argv[++i];
+            if (mode != "float" && mode != "exact") {
+                cerr << "Invalid time mode '" << mode << "'\n";
+                return VALIDATION_ERROR;
+            }
+            exact = mode == "exact";
+        } else if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc &&
+            (arg[1] == TOLERANCE_ARG || arg[1] == THREADS_ARG || arg[1] == FPS_ARG)) {
+            try {
+                double value = stod(argv[++i]);
+                if (arg[1] == TOLERANCE_ARG)
+                    tolerance = value;
+                else if (arg[1] == FPS_ARG && value >= 1 && value == floor(value))
+                    framePerSec = int(value);
+                else if (arg[1] == THREADS_ARG)
+                    threads = unsigned(max(0.0, value));
+                else
+                    throw invalid_argument("frames per second");
+            }
+            catch (exception &) {
+                cerr << "Invalid number '" << argv[i] << "'\n";
+                return VALIDATION_ERROR;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            showHelp();
+            return VALIDATION_ERROR;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() != 2) {
+        showHelp();
+        return VALIDATION_ERROR;
+    }
+    TaskPool::setSharedThreadCount(threads);
+
+    try {
+        Timeline timeline(files[0]);
+        Constraints constraints = timeline.deserializeConstraints(files[1]);
+        auto start = chrono::steady_clock::now();
+        vector<Violation> violations = validateTimeline(
+                timeline.getStates(), constraints,
+                RuntimeSimConfig(framePerSec, exact), tolerance);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        array<size_t, VIOLATION_TYPES> counts{};
+        for (const Violation &v: violations) {
+            if (counts[v.type]++ < MAX_REPORTED)
+                printViolation(v);
+        }
+        cout << timeline.getStates().size() << " states checked in "
+             << elapsed.count() << " sec\n";
+        for (int type = 0; type < VIOLATION_TYPES; ++type) {
+            if (counts[type] > 0)
+                cout << violationName(ViolationType(type)) << " : " << counts[type]
+                     << " violations\n";
+        }
+        if (violations.empty()) {
+            cout << "The timeline is valid\n";
+            return VALID;
+        }
+        return INVALID;
+    }
+    catch (exception &e) {
+        cerr << "Exception occurred : " << e.what() << '\n';
+        return VALIDATION_ERROR;
+    }
+}
+
+void showHelp() {
+    cout << "Usage : DeepCleaner_Validate <Timeline> <Constraints> [-"
+         << TOLERANCE_ARG << " <Tolerance>] [-" << THREADS_ARG << " <Threads>] [-"
+         << FPS_ARG << " <Frames per second>] [-" << TIME_ARG << " <Time mode>]\n"
+         << "Checks the speeds, command times, collisions and decontaminations"
+         << " of a timeline\n"
+         << " -" << TOLERANCE_ARG << " : largest error ignored (default "
+         << VALIDATION_TOLERANCE << ")\n"
+         << " -" << THREADS_ARG << " : threads used, all the cores by default\n"
+         << " -" << FPS_ARG << " : frames per second of the simulation (default "
+         << DefaultSimConfig::framePerSec << ")\n"
+         << " -" << TIME_ARG << " : time mode of the simulation, float or exact"
+         << " (default float)\n";
+}
+
+void printViolation(const Violation &v) {
+    cout << v.time << " sec, " << violationName(v.type) << " : ";
+    switch (v.type) {
+        case SPEED_LIMIT:
+            cout << "robot " << v.id << " speed " << v.value << ", limit " << v.limit;
+            break;
+        case COMMAND_TIME:
+            cout << "robot " << v.id << " speed changed, nearest command time "
+                 << v.limit;
+            break;
+        case TRAJECTORY:
+            cout << "robot " << v.id << " is " << v.value
+                 << " away from where its speeds lead";
+            break;
+        case ROBOT_OVERLAP:
+            cout << "robots " << v.id << " and " << v.otherId << " overlap, distance "
+                 << v.value << " below " << v.limit;
+            break;
+        case PARTICLE_OVERLAP:
+            cout << "robot " << v.id << " overlaps particle " << v.otherId
+                 << ", distance " << v.value << " below " << v.limit;
+            break;
+        case DECONTAMINATION:
+            cout << "robot " << v.id << " ate particle " << v.otherId
+                 << " without scoring its area " << v.value;
+            break;
+        case CAPTURE_ANGLE:
+            cout << "robot " << v.id << " ate particle " << v.otherId << " at "
+                 << v.value << " deg, capture angle " << v.limit;
+            break;
+        case PARTICLE_REMOVAL:
+            cout << "particle " << v.id << " removed before its explosion at "
+                 << v.limit;
+            break;
+    }
+    cout << '\n';
+}
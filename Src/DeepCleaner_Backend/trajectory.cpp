@@ -1,49 +1,57 @@
+#include <cmath>
 #include "utils.h"
+#include "fasttrig.h"
 #include "trajectory.h"
 
-const int FRAME_PER_SEC = 24;
-const double TIME_PER_FRAME = 1.0 / FRAME_PER_SEC;
+// Angles are in radians, in [0, TWO_PI[
+const double TWO_PI = 2 * M_PI;
 
 double getArea(double radius){
     return M_PI * radius * radius;
 }
 
 double getAngle(Position p1, Position p2) {
-	double deltaY = abs(p1.getY() - p2.getY());
-	double deltaX = abs(p1.getX() - p2.getX());
+#ifdef WITH_FAST_TRIG
+	// Also defined when both positions are the same
+	double angle = fastAtan2(p2.getY() - p1.getY(), p2.getX() - p1.getX());
+	return angle < 0 ? angle + TWO_PI : angle;
+#else
+	double deltaY = std::abs(p1.getY() - p2.getY());
+	double deltaX = std::abs(p1.getX() - p2.getX());
 	double targetAngle = atan(deltaY / deltaX);
 
 	if (p2.getX() >= p1.getX() && p2.getY() >= p1.getY()) {
 		return targetAngle;
 	} else if (p2.getX() < p1.getX() && p2.getY() > p1.getY()) {
-		return toRad(180) - targetAngle;
+		return M_PI - targetAngle;
 	} else if (p2.getX() <= p1.getX() && p2.getY() <= p1.getY()) {
-		return toRad(180) + targetAngle;
+		return M_PI + targetAngle;
 	}
-	return toRad(360) - targetAngle;
+	return TWO_PI - targetAngle;
+#endif
 }
 
 double deltaAngle(double originAngle, double targetAngle) {
 	double result;
 	if (targetAngle >= originAngle) {
-		if (targetAngle - originAngle < toRad(180))
+		if (targetAngle - originAngle < M_PI)
 			result = targetAngle - originAngle;
-		else result = toRad(360) - targetAngle + originAngle;
+		else result = TWO_PI - targetAngle + originAngle;
 	} else {
-		if (originAngle - targetAngle < toRad(180))
+		if (originAngle - targetAngle < M_PI)
 			result = originAngle - targetAngle;
-		else result = toRad(360) - originAngle + targetAngle;
+		else result = TWO_PI - originAngle + targetAngle;
 	}
 	return result;
 }
 
 AngularDirection rotateShortestPath(double originAngle, double targetAngle) {
 	if (targetAngle >= originAngle) {
-		if (targetAngle - originAngle < toRad(180))
+		if (targetAngle - originAngle < M_PI)
 			return CW;
 		else return CCW;
 	} else {
-		if (originAngle - targetAngle < toRad(180))
+		if (originAngle - targetAngle < M_PI)
 			return CCW;
 		else return CW;
 	}
@@ -51,32 +59,55 @@ AngularDirection rotateShortestPath(double originAngle, double targetAngle) {
 
 Position updateCoordinate(Position pos, double speed, double angle, double
 deltaTime) {
+	return updateCoordinate(pos, speed, fastSinCos(angle), deltaTime);
+}
+
+Position updateCoordinate(Position pos, double speed, SinCos heading,
+								  double deltaTime) {
 	Position targetPos(0, 0);
 	//Calculate the target position
 	double distance = speed * deltaTime;
-	targetPos.setX(pos.getX() + distance * cos(angle));
+	targetPos.setX(pos.getX() + distance * heading.cosine);
 	//We had to inverse Y because in QT the plan is inverted for Y axis
-	targetPos.setY(pos.getY() + distance * sin(angle));
+	targetPos.setY(pos.getY() + distance * heading.sine);
 	return targetPos;
 }
 Position front2xRobot(double r, double angle){
+	SinCos heading = fastSinCos(angle);
 	double x,y;
-	x = 3. * r * cos(angle) ;
-	y = 3. * r * sin(angle) ;
+	x = 3. * r * heading.cosine ;
+	y = 3. * r * heading.sine ;
 	return {x,y};
 }
 
 double linearDistance(Position p1, Position p2){
-    double deltaX = abs(p1.getX() - p2.getX());
-    double deltaY = abs(p1.getY() - p2.getY());
-    return abs(sqrt((deltaX * deltaX) + (deltaY * deltaY)));
+    double deltaX = std::abs(p1.getX() - p2.getX());
+    double deltaY = std::abs(p1.getY() - p2.getY());
+    return sqrt((deltaX * deltaX) + (deltaY * deltaY));
 }
 
-double getSyncTime(double time, const double refreshRate) {
+double getSyncTime(double time, const double refreshRate, double timePerFrame) {
 	double remainder = fmod(time, refreshRate);
 	double syncTime = refreshRate - remainder;
    //One tick before command interval
-	return time + syncTime - TIME_PER_FRAME;
+	double synced = time + syncTime - timePerFrame;
+	// Shorter, the speeds would go above the limits
+	if (synced < time)
+		synced += refreshRate;
+	return synced;
+}
+
+double getExactSyncTime(double time, double refreshRate, double timePerFrame) {
+	double nextCommand = (std::floor(time / refreshRate) + 1) * refreshRate;
+	if (nextCommand - timePerFrame < time)
+		nextCommand += refreshRate;
+	return nextCommand - timePerFrame;
+}
+
+bool isCommandFrame(double time, double interval, double timePerFrame,
+						  double tolerance) {
+	double nextCommand = std::ceil((time - tolerance) / interval) * interval;
+	return nextCommand < time + 2 * timePerFrame - tolerance;
 }
 
 double toRad(double deg) {
@@ -92,25 +123,25 @@ double angularSpeed(double radius, double leftSpeed, double rightSpeed) {
 }
 
 double rotationTime(double angle, double angularSpeed) {
-	return abs(angle / angularSpeed);
+	return std::abs(angle / angularSpeed);
 }
 
 double updateAngle(double angle, double radius, double leftSpeed, double rightSpeed,
 						 double deltaTime) {
 	double omega = angularSpeed(radius, leftSpeed, rightSpeed);
 	double temp = angle + omega * deltaTime;
-	if (toDeg(temp) < 0) {
-		return toRad(360) + temp;
-	} else if (toDeg(temp) > 360) {
-		return temp - toRad(360);
+	if (temp < 0) {
+		return TWO_PI + temp;
+	} else if (temp > TWO_PI) {
+		return temp - TWO_PI;
 	}
 	return temp;
 }
 
 bool detectCollision(Position p1, double radius1, Position p2, double radius2,
 							double epsilon) {
-	double deltaX = abs(p1.getX() - p2.getX());
-	double deltaY = abs(p1.getY() - p2.getY());
+	double deltaX = std::abs(p1.getX() - p2.getX());
+	double deltaY = std::abs(p1.getY() - p2.getY());
 	double distance = sqrt(deltaX * deltaX + deltaY * deltaY);
 	//TODO Need to add the epsilon error margin
 	return distance <= radius1 + radius2 + epsilon;
@@ -1,7 +1,9 @@
 #ifndef TRAJECTORY_H
 #define TRAJECTORY_H
 
+#include "fasttrig.h"
 #include "position.h"
+#include "simconfig.h"
 
 enum AngularDirection {
 	CW, CCW
@@ -14,6 +16,10 @@ AngularDirection rotateShortestPath(double originAngle, double targetAngle);
 Position updateCoordinate(Position pos, double speed, double angle, double
 deltaTime);
 
+// Same, the sine and cosine of the angle already computed
+Position updateCoordinate(Position pos, double speed, SinCos heading,
+								  double deltaTime);
+
 double toRad(double deg);
 
 double toDeg(double rad);
@@ -28,7 +34,19 @@ double deltaAngle(double originAngle, double targetAngle);
 
 double linearDistance(Position p1, Position p2);
 
-double getSyncTime(double time, const double refreshRate);
+// Last frame before the next multiple of refreshRate, the one after when time
+// ends in that frame, so the synced move is never faster than the given one
+double getSyncTime(double time, const double refreshRate,
+						 double timePerFrame = DefaultSimConfig::timePerFrame);
+
+// Same frame, the next multiple of refreshRate is a single product, the same
+// for every time between two multiples
+double getExactSyncTime(double time, double refreshRate, double timePerFrame);
+
+// A multiple of interval falls in the frame starting at time or in the next
+// one, the frame before a command time or the one holding it
+bool isCommandFrame(double time, double interval, double timePerFrame,
+						  double tolerance);
 
 double rotationTime(double angle, double angularSpeed);
 
@@ -13,8 +13,7 @@ std::string addExtension(const std::string &fileName, const std::string &extensi
         return "no_name" + ext;
 
     size_t extLen =  ext.size();
-    std::string searchedExt = fn.substr(fn.size() - extLen, extLen);
-    if (searchedExt == ext) {
+    if (fn.size() >= extLen && fn.compare(fn.size() - extLen, extLen, ext) == 0) {
         return fn;
     }
     return fn + ext;
@@ -48,28 +47,11 @@ void emptyBuffer(){
     while ((c = getchar()) != '\n' && c != EOF);
 }
 
-std::string setRelativePath(const std::string &path, std::string &fileName, const
-std::string &extension) {
-    std::string ext;
-    size_t pointPos;
-
-    // get the extension
-    pointPos = fileName.find_last_of('.');
-    if (pointPos != std::string::npos)
-        ext = fileName.substr(pointPos);
-
-    // If the given file has a wrong extension
-    if (ext != extension && pointPos != std::string::npos) {
-        std::cout << fileName << " : File extension not supported. please give a "
-        << extension << " file.\n";
-        fileName.clear();
-        pause("Press a key to quit...");
-        exit(EXIT_SUCCESS);
-    }
-
-    // If the file has no extension
-    if (pointPos == std::string::npos)
-        fileName += extension;
-
-    return path + fileName;
-}
\ No newline at end of file
+std::string withExtension(const std::string &path, const std::string &extension) {
+    // The separators of both systems, a Windows path is read anywhere
+    size_t nameStart = path.find_last_of("/\\");
+    nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+    if (path.find('.', nameStart) != std::string::npos)
+        return path;
+    return path + extension;
+}
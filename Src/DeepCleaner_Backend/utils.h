@@ -1,7 +1,10 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 std::string addExtension(const std::string &fileName, const std::string &extension);
 
@@ -13,6 +16,14 @@ void pause(const std::string &msg);
 
 void emptyBuffer();
 
-std::string setRelativePath(const std::string &path, std::string &fileName, const
-std::string &extension);
+// The path with the extension added if its file name has none
+std::string withExtension(const std::string &path, const std::string &extension);
+
+// Room for size values. The capacity doubles, a list that grows a few values
+// at a time is seldom allocated again
+template<typename T>
+void reserveFor(std::vector<T> &values, std::size_t size) {
+	if (values.capacity() < size)
+		values.reserve(std::max(size, 2 * values.capacity()));
+}
 #endif // UTILS_H
@@ -0,0 +1,429 @@
+/*-----------------------------------------------------------------------------
+File name : validator.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the timeline validator. Two bodies moving in a
+line meet at a root of a second degree equation. When a robot is on an arc,
+the distance cannot change faster than the sum of the speeds, which bounds it
+on a whole sub-interval, so only the parts that may overlap are split again.
+Only the robots and particles whose boxes, the robots grown by the distance
+they may travel during the interval, overlap are checked against each other.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+#include <unordered_map>
+#include "validator.h"
+#include "fasttrig.h"
+#include "fixedpoint.h"
+#include "kinematics.h"
+#include "sweepprune.h"
+#include "taskpool.h"
+#include "trajectory.h"
+
+// Errors allowed by the checks, from the configuration of the engine
+struct Limits {
+	double tolerance = VALIDATION_TOLERANCE; // given by the user
+	double frame = DefaultSimConfig::timePerFrame;        // sec
+	double epsilon = DefaultSimConfig::collisionEpsilon;  // pixels, margin of a contact
+	double explosion = DefaultSimConfig::explosionTolerance; // sec, early explosions
+	double grid = 0.0; // pixels a frame may round a position, 0 out of exact mode
+	double fine = 0.0; // rad or pixel/sec a frame may round an angle or a speed
+
+	double frames(double duration) const {
+		return std::ceil(duration / frame - tolerance) + 1;
+	}
+
+	// Largest error on a position after an interval (pixels)
+	double position(double duration) const {
+		return tolerance + grid * frames(duration);
+	}
+
+	// Largest error on an angle after an interval (deg)
+	double angle(double duration) const {
+		return tolerance + toDeg(fine * frames(duration));
+	}
+
+	double speed() const { return tolerance + fine; }
+};
+
+// Movement of a body from the start of an interval
+struct Motion {
+	int id = -1;
+	Position start;
+	double radius = 0.0;
+	double heading = 0.0; // rad
+	double speed = 0.0;   // linear speed of the center
+	double omega = 0.0;   // rad/s, 0 in a line
+	double moving = INFINITY; // sec, the body stays still after it
+
+	bool isArc() const { return speed != 0 && omega != 0; }
+
+	Position at(double t) const {
+		return arcPosition(start, heading, speed, omega, std::min(t, moving));
+	}
+
+	double headingAt(double t) const { return heading + omega * std::min(t, moving); }
+};
+
+static Motion robotMotion(const Robot &r, double moving) {
+	Motion m;
+	m.id = r.getId();
+	m.start = r.getPosition();
+	m.radius = r.getRadius();
+	m.heading = r.getAngle(RAD);
+	m.speed = (r.getLeftSpeed() + r.getRightSpeed()) / 2;
+	m.omega = angularSpeed(r.getRadius(), r.getLeftSpeed(), r.getRightSpeed());
+	m.moving = moving;
+	return m;
+}
+
+static Motion particleMotion(const Particle &p) {
+	Motion m;
+	m.id = p.getId();
+	m.start = p.getPosition();
+	m.radius = p.getRadius();
+	return m;
+}
+
+// Unlike getAngle, defined when both positions are the same
+static double direction(const Position &from, const Position &to) {
+	return fastAtan2(to.getY() - from.getY(), to.getX() - from.getX());
+}
+
+static std::pmr::unordered_map<int, const Robot *>
+robotsById(const State &state, std::pmr::memory_resource *arena) {
+	std::pmr::unordered_map<int, const Robot *> robots(arena);
+	robots.reserve(state.getRobots().size());
+	for (const Robot &r: state.getRobots())
+		robots.emplace(r.getId(), &r);
+	return robots;
+}
+
+static bool speedsChanged(const Robot &r, const Robot &next, const Limits &limits) {
+	return std::abs(next.getLeftSpeed() - r.getLeftSpeed()) > limits.speed() ||
+			 std::abs(next.getRightSpeed() - r.getRightSpeed()) > limits.speed();
+}
+
+// Time the robot follows its speeds. The engine gives the new speeds of a robot
+// in a frame where it does not move, the last one of the interval
+static double movingTime(const Robot &r, const Robot *next, double duration,
+								 const Limits &limits) {
+	if (next == nullptr || !speedsChanged(r, *next, limits))
+		return duration;
+	return std::max(0.0, duration - limits.frame);
+}
+
+static double contactGap(const Position &a, double radiusA, const Position &b,
+								 double radiusB) {
+	return linearDistance(a, b) - radiusA - radiusB;
+}
+
+static bool touches(const Position &a, double radiusA, const Position &b,
+						  double radiusB, const Limits &limits) {
+	return contactGap(a, radiusA, b, radiusB) <=
+			 limits.epsilon + limits.position(limits.frame);
+}
+
+static double distanceAt(const Motion &a, const Motion &b, double t) {
+	return linearDistance(a.at(t), b.at(t));
+}
+
+// Earliest t in [0, duration] where the centers are closer than limit
+static bool lineOverlap(const Motion &a, const Motion &b, double duration,
+								double limit, double &time) {
+	Position pa = a.at(0), pb = b.at(0);
+	double px = pa.getX() - pb.getX(), py = pa.getY() - pb.getY();
+	double vx = a.speed * cos(a.heading) - b.speed * cos(b.heading);
+	double vy = a.speed * sin(a.heading) - b.speed * sin(b.heading);
+	double squaredSpeed = vx * vx + vy * vy;
+	double dot = px * vx + py * vy;
+	double discriminant = dot * dot - squaredSpeed * (px * px + py * py - limit * limit);
+	if (squaredSpeed == 0 || dot >= 0 || discriminant <= 0)
+		return false;
+	double entry = (-dot - sqrt(discriminant)) / squaredSpeed;
+	if (entry > duration)
+		return false;
+	time = std::max(0.0, entry);
+	return true;
+}
+
+static bool arcOverlap(const Motion &a, const Motion &b, double start, double end,
+							  double dStart, double dEnd, double rate, double limit,
+							  double tolerance, double &time) {
+	// Smallest distance possible in [start, end]
+	if ((dStart + dEnd - rate * (end - start)) / 2 >= limit)
+		return false;
+	double middle = (start + end) / 2;
+	double dMiddle = distanceAt(a, b, middle);
+	bool splittable = end - start > tolerance / rate;
+	if (splittable && arcOverlap(a, b, start, middle, dStart, dMiddle, rate, limit,
+										  tolerance, time))
+		return true;
+	if (dMiddle < limit) {
+		time = middle;
+		return true;
+	}
+	return splittable && arcOverlap(a, b, middle, end, dMiddle, dEnd, rate, limit,
+											  tolerance, time);
+}
+
+static bool findOverlap(const Motion &a, const Motion &b, double duration,
+								double tolerance, double &time) {
+	double limit = a.radius + b.radius - tolerance;
+	double rate = std::abs(a.speed) + std::abs(b.speed);
+	double dStart = distanceAt(a, b, 0);
+	if (dStart < limit) {
+		time = 0;
+		return true;
+	}
+	if (rate == 0 || dStart - rate * duration >= limit)
+		return false;
+	// The straight moves for the whole interval meet at a root
+	if (!a.isArc() && !b.isArc() && a.moving >= duration && b.moving >= duration)
+		return lineOverlap(a, b, duration, limit, time);
+
+	double dEnd = distanceAt(a, b, duration);
+	if (arcOverlap(a, b, 0, duration, dStart, dEnd, rate, limit, tolerance, time))
+		return true;
+	time = duration;
+	return dEnd < limit;
+}
+
+// In contact with a robot or a particle of next, or with a particle of state
+// gone in next, a collision may then have changed its speeds
+static bool hasCollided(const Robot &r, const State &state, const State &next,
+								const Limits &limits) {
+	for (const Robot &other: next.getRobots()) {
+		if (other.getId() != r.getId() &&
+			 touches(r.getPosition(), r.getRadius(), other.getPosition(),
+						other.getRadius(), limits))
+			return true;
+	}
+	for (const State *s: {&next, &state}) {
+		for (const Particle &p: s->getParticles()) {
+			if (touches(r.getPosition(), r.getRadius(), p.getPosition(), p.getRadius(),
+							limits))
+				return true;
+		}
+	}
+	return false;
+}
+
+static double angleDifference(double a, double b) {
+	return std::abs(std::remainder(a - b, 2 * M_PI));
+}
+
+static void checkSpeeds(const State &state, const Constraints &constraints,
+								const Limits &limits, std::vector<Violation> &found) {
+	for (const Robot &r: state.getRobots()) {
+		for (double speed: {r.getLeftSpeed(), r.getRightSpeed()}) {
+			if (speed > constraints.maxForwardSpeed + limits.speed())
+				found.push_back({state.getTime(), SPEED_LIMIT, r.getId(), -1, speed,
+									  constraints.maxForwardSpeed});
+			else if (speed < -constraints.maxBackwardSpeed - limits.speed())
+				found.push_back({state.getTime(), SPEED_LIMIT, r.getId(), -1, speed,
+									  -constraints.maxBackwardSpeed});
+		}
+	}
+}
+
+static void checkOverlaps(const State &state, const State &next, const Limits &limits,
+								  std::pmr::memory_resource *arena,
+								  std::vector<Violation> &found) {
+	double duration = next.getTime() - state.getTime();
+	double tolerance = limits.position(duration);
+	const RobotList &robots = state.getRobots();
+	const ParticleList &particles = state.getParticles();
+	std::pmr::unordered_map<int, const Robot *> nextRobots = robotsById(next, arena);
+	// The robots first, then the particles, so a pair starts with a robot
+	std::pmr::vector<Motion> motions(arena);
+	std::pmr::vector<SweepBox> boxes(arena);
+	motions.reserve(robots.size() + particles.size());
+	boxes.reserve(robots.size() + particles.size());
+	for (const Robot &r: robots) {
+		auto n = nextRobots.find(r.getId());
+		motions.push_back(robotMotion(r, movingTime(r, n == nextRobots.end() ? nullptr
+																							  : n->second,
+																  duration, limits)));
+		// Nowhere else during the interval, an arc is longer than its chord
+		boxes.push_back(boxAround(r.getPosition(), r.getRadius() +
+											std::abs(motions.back().speed) * duration));
+	}
+	for (const Particle &p: particles) {
+		motions.push_back(particleMotion(p));
+		boxes.push_back(boxAround(p.getPosition(), p.getRadius()));
+	}
+	SweepAndPrune sweep;
+	const std::vector<SweepPair> &pairs = sweep.update(boxes);
+
+	double time;
+	auto pair = pairs.begin();
+	for (std::size_t i = 0; i < robots.size(); ++i) {
+		const Motion &a = motions[i];
+		for (; pair != pairs.end() && pair->first == i; ++pair) {
+			const Motion &b = motions[pair->second];
+			if (!findOverlap(a, b, duration, tolerance, time))
+				continue;
+			ViolationType type = pair->second < robots.size() ? ROBOT_OVERLAP
+																			  : PARTICLE_OVERLAP;
+			found.push_back({state.getTime() + time, type, a.id, b.id,
+								  distanceAt(a, b, time), a.radius + b.radius});
+		}
+	}
+}
+
+static void checkRobotChanges(const State &state, const State &next,
+										const Constraints &constraints, const Limits &limits,
+										std::pmr::memory_resource *arena,
+										std::vector<Violation> &found) {
+	double duration = next.getTime() - state.getTime();
+	std::pmr::unordered_map<int, const Robot *> nextRobots = robotsById(next, arena);
+	for (const Robot &r: state.getRobots()) {
+		auto match = nextRobots.find(r.getId());
+		if (match == nextRobots.end())
+			continue;
+		const Robot *n = match->second;
+
+		Motion motion = robotMotion(r, movingTime(r, n, duration, limits));
+		double gap = linearDistance(motion.at(duration), n->getPosition());
+		double turn = toDeg(angleDifference(motion.headingAt(duration), n->getAngle(RAD)));
+		if (gap > limits.position(duration))
+			found.push_back({next.getTime(), TRAJECTORY, r.getId(), -1, gap, 0.0});
+		else if (turn > limits.angle(duration))
+			found.push_back({next.getTime(), TRAJECTORY, r.getId(), -1, turn, 0.0});
+
+		if (!speedsChanged(r, *n, limits) || hasCollided(*n, state, next, limits))
+			continue;
+		// The engine gives the commands in the frame before the command times,
+		// the robots then move from the command times
+		double interval = constraints.commandTimeInterval;
+		double time = next.getTime();
+		if (!isCommandFrame(time, interval, limits.frame, limits.tolerance))
+			found.push_back({time, COMMAND_TIME, r.getId(), -1, time,
+								  std::round(time / interval) * interval});
+	}
+}
+
+// Touching the particle and turned toward it, the angle in deg
+struct Capture {
+	const Robot *robot = nullptr;
+	bool scored = false;
+	double angle = INFINITY;
+};
+
+static void checkRemovals(const State &state, const State &next, const Limits &limits,
+								  std::pmr::memory_resource *arena,
+								  std::vector<Violation> &found) {
+	const ParticleList &nextParticles = next.getParticles();
+	std::pmr::vector<int> remaining(arena);
+	remaining.reserve(nextParticles.size());
+	for (const Particle &p: nextParticles)
+		remaining.push_back(p.getId());
+	std::sort(remaining.begin(), remaining.end());
+
+	std::pmr::unordered_map<int, const Robot *> robots = robotsById(state, arena);
+	for (const Particle &p: state.getParticles()) {
+		if (std::binary_search(remaining.begin(), remaining.end(), p.getId()))
+			continue;
+
+		// The robots touching the particle when it went, the nearest to its
+		// direction first
+		std::pmr::vector<Capture> captures(arena);
+		for (const Robot &n: next.getRobots()) {
+			if (!touches(n.getPosition(), n.getRadius(), p.getPosition(), p.getRadius(),
+							 limits))
+				continue;
+			auto r = robots.find(n.getId());
+			bool scored = r != robots.end() &&
+							  n.getScore() > r->second->getScore() + limits.tolerance;
+			double angle = toDeg(angleDifference(direction(n.getPosition(),
+																		  p.getPosition()),
+															 n.getAngle(RAD)));
+			captures.push_back({&n, scored, angle});
+		}
+		std::sort(captures.begin(), captures.end(),
+					 [](const Capture &a, const Capture &b) { return a.angle < b.angle; });
+		auto canEat = [&](const Capture &c) {
+			return c.angle <= c.robot->getCaptureAngle(DEG) + limits.angle(limits.frame);
+		};
+		auto eater = std::find_if(captures.begin(), captures.end(), [&](const Capture &c) {
+			return c.scored && canEat(c);
+		});
+		if (eater != captures.end())
+			continue;
+
+		const ExplosionTimes &times = p.getExplosionTimes();
+		double explosion = times.empty() || times[0].empty() ? INFINITY : times[0][0];
+		if (next.getTime() >= explosion - limits.explosion - limits.tolerance)
+			continue;
+
+		// A robot could eat it but did not score, or scored out of its angle
+		auto capture = std::find_if(captures.begin(), captures.end(), canEat);
+		auto scorer = std::find_if(captures.begin(), captures.end(),
+											[](const Capture &c) { return c.scored; });
+		if (capture != captures.end())
+			found.push_back({next.getTime(), DECONTAMINATION, capture->robot->getId(),
+								  p.getId(), getArea(p.getRadius()), 0.0});
+		else if (scorer != captures.end())
+			found.push_back({next.getTime(), CAPTURE_ANGLE, scorer->robot->getId(),
+								  p.getId(), scorer->angle,
+								  scorer->robot->getCaptureAngle(DEG)});
+		else
+			found.push_back({next.getTime(), PARTICLE_REMOVAL, p.getId(), -1,
+								  next.getTime(), explosion});
+	}
+}
+
+std::string violationName(ViolationType type) {
+	switch (type) {
+		case SPEED_LIMIT: return "speedLimit";
+		case COMMAND_TIME: return "commandTime";
+		case TRAJECTORY: return "trajectory";
+		case ROBOT_OVERLAP: return "robotOverlap";
+		case PARTICLE_OVERLAP: return "particleOverlap";
+		case DECONTAMINATION: return "decontamination";
+		case CAPTURE_ANGLE: return "captureAngle";
+		default: return "particleRemoval";
+	}
+}
+
+std::vector<Violation> validateTimeline(std::span<const State> states,
+													 const Constraints &constraints,
+													 const RuntimeSimConfig &config,
+													 double tolerance) {
+	Limits limits;
+	limits.tolerance = tolerance;
+	limits.frame = config.timePerFrame;
+	limits.epsilon = config.collisionEpsilon;
+	limits.explosion = config.explosionTolerance;
+	if (config.exact) {
+		limits.grid = 1 / FIXED_ONE;
+		limits.fine = 1 / FINE_ONE;
+	}
+
+	// One list per state, merged in order once every interval is checked. The
+	// temporaries of an interval come from the arena of the thread checking it
+	std::vector<std::vector<Violation>> found(states.size());
+	TaskPool::shared().parallelFor(states.size(), [&](std::size_t i) {
+		checkSpeeds(states[i], constraints, limits, found[i]);
+		if (i + 1 == states.size())
+			return;
+		const State &state = states[i], &next = states[i + 1];
+		std::pmr::memory_resource *arena = TaskPool::threadArena();
+		checkOverlaps(state, next, limits, arena, found[i]);
+		checkRobotChanges(state, next, constraints, limits, arena, found[i]);
+		checkRemovals(state, next, limits, arena, found[i]);
+	});
+
+	std::vector<Violation> violations;
+	for (std::vector<Violation> &list: found)
+		violations.insert(violations.end(), list.begin(), list.end());
+	std::stable_sort(violations.begin(), violations.end(),
+						  [](const Violation &a, const Violation &b) {
+							  return a.time < b.time;
+						  });
+	return violations;
+}
@@ -0,0 +1,63 @@
+/*-----------------------------------------------------------------------------
+File name : validator.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the timeline validator, checking the rules of the
+Explications folder (Command, Collisions, Decontamination). Between two states
+the robots follow their wheel speeds, in a line, on an arc or on themselves,
+and every interval is checked on its whole duration rather than frame by
+frame. The intervals are checked in parallel on the shared task pool. The
+configuration of the engine gives its frame, during which a robot given new
+speeds does not move, and in exact mode its grid, on which every frame rounds
+the positions.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+#include "simconfig.h"
+#include "state.h"
+#include "timeline.h"
+
+const double VALIDATION_TOLERANCE = 1e-6;
+
+typedef enum {
+	SPEED_LIMIT,      // wheel speed above maxForwardSpeed or maxBackwardSpeed
+	COMMAND_TIME,     // voluntary speed change out of the frame holding a
+	                  // commandTimeInterval multiple, or the frame before it
+	TRAJECTORY,       // robot not where its speeds of the previous state lead
+	ROBOT_OVERLAP,    // two robots overlapping
+	PARTICLE_OVERLAP, // a robot overlapping a particle
+	DECONTAMINATION,  // particle eaten by a robot that did not score
+	CAPTURE_ANGLE,    // particle eaten out of the capture angle of the robot
+	PARTICLE_REMOVAL  // particle gone before its explosion time, no robot could eat it
+} ViolationType;
+
+const int VIOLATION_TYPES = PARTICLE_REMOVAL + 1;
+
+struct Violation {
+	double time = 0.0;
+	ViolationType type = SPEED_LIMIT;
+	int id = -1;      // robot, or particle for PARTICLE_REMOVAL
+	int otherId = -1; // other robot or particle, -1 if none
+	double value = 0.0; // what was found (speed, distance, angle in degrees...)
+	double limit = 0.0; // what the rule allows
+};
+
+// Name used in the reports (speedLimit, commandTime...)
+std::string violationName(ViolationType type);
+
+// Violations ordered by time, for a timeline made with config. The contacts
+// use its collision margin, and in exact mode the tolerance grows with the
+// rounding of the frames of an interval
+std::vector<Violation> validateTimeline(std::span<const State> states,
+													 const Constraints &constraints,
+													 const RuntimeSimConfig &config = RuntimeSimConfig(),
+													 double tolerance = VALIDATION_TOLERANCE);
+
+#endif // VALIDATOR_H
@@ -0,0 +1,358 @@
+/*-----------------------------------------------------------------------------
+File name : blockfile.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the compressed timeline files. The codecs are
+enabled by the build (WITH_ZLIB, WITH_ZSTD, WITH_LZ4)
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include "blockfile.h"
+#include "json.hpp"
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef WITH_LZ4
+#include <lz4.h>
+#endif
+
+using json = nlohmann::json;
+using Bytes = std::vector<char>;
+
+const char MAGIC[4] = {'D', 'C', 'T', 'B'};
+const std::uint8_t VERSION = 2;
+const std::uint8_t FIRST_SUMMARY_VERSION = 2;
+const std::size_t HEADER_SIZE = 24;
+const std::size_t INDEX_ENTRY_SIZE = 28;
+const std::size_t SUMMARY_ENTRY_SIZE = 24;
+const int ZLIB_LEVEL = 6;
+const int ZSTD_LEVEL = 3;
+
+static void putInt(Bytes &out, std::uint64_t value, unsigned size) {
+	for (unsigned i = 0; i < size; ++i)
+		out.push_back(char((value >> (8 * i)) & 0xFF));
+}
+
+static std::uint64_t getInt(const char *in, unsigned size) {
+	std::uint64_t value = 0;
+	for (unsigned i = 0; i < size; ++i)
+		value |= std::uint64_t(std::uint8_t(in[i])) << (8 * i);
+	return value;
+}
+
+static void putDouble(Bytes &out, double value) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	putInt(out, bits, 8);
+}
+
+static double getDouble(const char *in) {
+	std::uint64_t bits = getInt(in, 8);
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// Same score as the UI computes from the robots and the particles
+static StateSummary summarize(const State &state) {
+	StateSummary summary;
+	summary.time = state.getTime();
+	for (const Robot &r: state.getRobots())
+		summary.score += r.getScore();
+	for (const Particle &p: state.getParticles())
+		summary.remainingArea += p.getRadius() * p.getRadius() * M_PI;
+	return summary;
+}
+
+static Bytes compress(BlockCodec codec, const std::string &raw) {
+	Bytes out;
+	switch (codec) {
+		case NO_CODEC:
+			out.assign(raw.begin(), raw.end());
+			break;
+#ifdef WITH_ZLIB
+		case ZLIB_CODEC: {
+			uLongf size = compressBound(uLong(raw.size()));
+			out.resize(size);
+			if (compress2(reinterpret_cast<Bytef *>(out.data()), &size,
+							  reinterpret_cast<const Bytef *>(raw.data()),
+							  uLong(raw.size()), ZLIB_LEVEL) != Z_OK)
+				throw std::runtime_error("zlib compression failed");
+			out.resize(size);
+			break;
+		}
+#endif
+#ifdef WITH_ZSTD
+		case ZSTD_CODEC: {
+			out.resize(ZSTD_compressBound(raw.size()));
+			std::size_t size = ZSTD_compress(out.data(), out.size(), raw.data(),
+														raw.size(), ZSTD_LEVEL);
+			if (ZSTD_isError(size))
+				throw std::runtime_error(ZSTD_getErrorName(size));
+			out.resize(size);
+			break;
+		}
+#endif
+#ifdef WITH_LZ4
+		case LZ4_CODEC: {
+			out.resize(LZ4_compressBound(int(raw.size())));
+			int size = LZ4_compress_default(raw.data(), out.data(), int(raw.size()),
+													  int(out.size()));
+			if (size <= 0)
+				throw std::runtime_error("lz4 compression failed");
+			out.resize(size);
+			break;
+		}
+#endif
+		default:
+			throw std::runtime_error("The " + codecName(codec) +
+											 " codec is not available in this build");
+	}
+	return out;
+}
+
+static std::string decompress(BlockCodec codec, const Bytes &data,
+										std::size_t rawSize) {
+	std::string raw(rawSize, '\0');
+	bool ok = false;
+	switch (codec) {
+		case NO_CODEC:
+			raw.assign(data.begin(), data.end());
+			ok = raw.size() == rawSize;
+			break;
+#ifdef WITH_ZLIB
+		case ZLIB_CODEC: {
+			uLongf size = uLongf(rawSize);
+			ok = uncompress(reinterpret_cast<Bytef *>(raw.data()), &size,
+								 reinterpret_cast<const Bytef *>(data.data()),
+								 uLong(data.size())) == Z_OK && size == rawSize;
+			break;
+		}
+#endif
+#ifdef WITH_ZSTD
+		case ZSTD_CODEC: {
+			std::size_t size = ZSTD_decompress(raw.data(), raw.size(), data.data(),
+														  data.size());
+			ok = !ZSTD_isError(size) && size == rawSize;
+			break;
+		}
+#endif
+#ifdef WITH_LZ4
+		case LZ4_CODEC:
+			ok = LZ4_decompress_safe(data.data(), raw.data(), int(data.size()),
+											 int(rawSize)) == int(rawSize);
+			break;
+#endif
+		default:
+			throw std::runtime_error("The " + codecName(codec) +
+											 " codec is not available in this build");
+	}
+	if (!ok)
+		throw std::runtime_error("Corrupted block in the timeline file");
+	return raw;
+}
+
+std::string codecName(BlockCodec codec) {
+	switch (codec) {
+		case ZLIB_CODEC: return "zlib";
+		case ZSTD_CODEC: return "zstd";
+		case LZ4_CODEC: return "lz4";
+		default: return "none";
+	}
+}
+
+bool parseCodecName(const std::string &name, BlockCodec &codec) {
+	for (BlockCodec c: {NO_CODEC, ZLIB_CODEC, ZSTD_CODEC, LZ4_CODEC}) {
+		if (name == codecName(c)) {
+			codec = c;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool isCodecAvailable(BlockCodec codec) {
+	switch (codec) {
+		case NO_CODEC: return true;
+#ifdef WITH_ZLIB
+		case ZLIB_CODEC: return true;
+#endif
+#ifdef WITH_ZSTD
+		case ZSTD_CODEC: return true;
+#endif
+#ifdef WITH_LZ4
+		case LZ4_CODEC: return true;
+#endif
+		default: return false;
+	}
+}
+
+void writeBlocks(std::ostream &output, const std::vector<State> &states,
+					  BlockCodec codec, unsigned statesPerBlock) {
+	statesPerBlock = std::max(1u, statesPerBlock);
+	std::vector<BlockInfo> blocks;
+	std::uint64_t offset = HEADER_SIZE;
+
+	// The header is written last, once the index position is known
+	Bytes header(HEADER_SIZE, '\0');
+	output.write(header.data(), std::streamsize(header.size()));
+
+	for (std::size_t first = 0; first < states.size(); first += statesPerBlock) {
+		std::size_t last = std::min(states.size(), first + statesPerBlock);
+		json block;
+		json &blockStates = block["states"] = json::array();
+		for (std::size_t i = first; i < last; ++i)
+			blockStates.push_back(states[i]);
+
+		std::string raw;
+		json::to_cbor(block, raw);
+		Bytes data = compress(codec, raw);
+		output.write(data.data(), std::streamsize(data.size()));
+
+		BlockInfo info;
+		info.firstTime = states[first].getTime();
+		info.offset = offset;
+		info.compressedSize = std::uint32_t(data.size());
+		info.rawSize = std::uint32_t(raw.size());
+		info.stateCount = std::uint32_t(last - first);
+		blocks.push_back(info);
+		offset += data.size();
+	}
+
+	Bytes index;
+	for (const BlockInfo &info: blocks) {
+		putDouble(index, info.firstTime);
+		putInt(index, info.offset, 8);
+		putInt(index, info.compressedSize, 4);
+		putInt(index, info.rawSize, 4);
+		putInt(index, info.stateCount, 4);
+	}
+	for (const State &state: states) {
+		StateSummary summary = summarize(state);
+		putDouble(index, summary.time);
+		putDouble(index, summary.score);
+		putDouble(index, summary.remainingArea);
+	}
+	output.write(index.data(), std::streamsize(index.size()));
+
+	header.assign(MAGIC, MAGIC + sizeof(MAGIC));
+	putInt(header, VERSION, 1);
+	putInt(header, codec, 1);
+	putInt(header, 0, 2);
+	putInt(header, statesPerBlock, 4);
+	putInt(header, blocks.size(), 4);
+	putInt(header, offset, 8);
+	output.seekp(-std::streamoff(offset + index.size()), std::ios::cur);
+	output.write(header.data(), std::streamsize(header.size()));
+	output.seekp(0, std::ios::end);
+}
+
+BlockReader::BlockReader(std::istream &input) : input(input) {
+	start = input.tellg();
+	char header[HEADER_SIZE];
+	if (!input.read(header, HEADER_SIZE) ||
+		 std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0)
+		throw std::runtime_error("Not a compressed timeline file");
+	std::uint8_t version = std::uint8_t(header[4]);
+	if (version < 1 || version > VERSION)
+		throw std::runtime_error("Unsupported compressed timeline version");
+
+	std::uint8_t codecByte = std::uint8_t(header[5]);
+	if (codecByte > LZ4_CODEC)
+		throw std::runtime_error("Unknown codec " + std::to_string(codecByte) +
+										 " in the compressed timeline file");
+	codec = BlockCodec(codecByte);
+	std::size_t count = getInt(header + 12, 4);
+	std::uint64_t indexOffset = getInt(header + 16, 8);
+
+	// The counts of the file are bounded by its size before any allocation
+	input.seekg(0, std::ios::end);
+	std::uint64_t fileSize = std::uint64_t(input.tellg() - start);
+	if (indexOffset < HEADER_SIZE || indexOffset > fileSize ||
+		 count > (fileSize - indexOffset) / INDEX_ENTRY_SIZE)
+		throw std::runtime_error("Truncated compressed timeline file");
+
+	Bytes index(count * INDEX_ENTRY_SIZE);
+	input.seekg(start + std::streamoff(indexOffset));
+	if (!input.read(index.data(), std::streamsize(index.size())))
+		throw std::runtime_error("Truncated compressed timeline file");
+
+	blocks.resize(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		const char *entry = index.data() + i * INDEX_ENTRY_SIZE;
+		blocks[i].firstTime = getDouble(entry);
+		blocks[i].offset = getInt(entry + 8, 8);
+		blocks[i].compressedSize = std::uint32_t(getInt(entry + 16, 4));
+		blocks[i].rawSize = std::uint32_t(getInt(entry + 20, 4));
+		blocks[i].stateCount = std::uint32_t(getInt(entry + 24, 4));
+		// Every block lies between the header and the index
+		if (blocks[i].offset < HEADER_SIZE || blocks[i].offset > indexOffset ||
+			 blocks[i].compressedSize > indexOffset - blocks[i].offset)
+			throw std::runtime_error("Corrupted block index in the timeline file");
+	}
+
+	if (version < FIRST_SUMMARY_VERSION)
+		return;
+	std::size_t stateCount = 0;
+	for (const BlockInfo &info: blocks)
+		stateCount += info.stateCount;
+	std::uint64_t tableOffset = indexOffset + index.size();
+	if (stateCount > (fileSize - tableOffset) / SUMMARY_ENTRY_SIZE)
+		throw std::runtime_error("Truncated compressed timeline file");
+	Bytes table(stateCount * SUMMARY_ENTRY_SIZE);
+	if (!input.read(table.data(), std::streamsize(table.size())))
+		throw std::runtime_error("Truncated compressed timeline file");
+
+	summaries.resize(stateCount);
+	for (std::size_t i = 0; i < stateCount; ++i) {
+		const char *entry = table.data() + i * SUMMARY_ENTRY_SIZE;
+		summaries[i].time = getDouble(entry);
+		summaries[i].score = getDouble(entry + 8);
+		summaries[i].remainingArea = getDouble(entry + 16);
+	}
+}
+
+bool BlockReader::isBlockFile(std::istream &input) {
+	char magic[sizeof(MAGIC)] = {};
+	std::istream::pos_type position = input.tellg();
+	input.read(magic, sizeof(magic));
+	bool found = input.gcount() == sizeof(magic) &&
+					 std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+	input.clear();
+	input.seekg(position);
+	return found;
+}
+
+std::size_t BlockReader::findBlock(double time) const {
+	// Last block starting before the given time
+	auto next = std::upper_bound(blocks.begin(), blocks.end(), time,
+										  [](double t, const BlockInfo &b) {
+											  return t < b.firstTime;
+										  });
+	return next == blocks.begin() ? 0 : std::size_t(next - blocks.begin() - 1);
+}
+
+void BlockReader::readBlock(std::size_t index, const StateCallback &onState) {
+	const BlockInfo &info = blocks.at(index);
+	Bytes data(info.compressedSize);
+	input.seekg(start + std::streamoff(info.offset));
+	if (!input.read(data.data(), std::streamsize(data.size())))
+		throw std::runtime_error("Truncated compressed timeline file");
+
+	std::istringstream raw(decompress(codec, data, info.rawSize));
+	readStates(raw, onState);
+}
+
+void BlockReader::readAll(const StateCallback &onState) {
+	for (std::size_t i = 0; i < blocks.size(); ++i)
+		readBlock(i, onState);
+}
@@ -0,0 +1,96 @@
+/*-----------------------------------------------------------------------------
+File name : blockfile.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the compressed timeline files. The states are cut in
+blocks of N states, each block is a CBOR timeline compressed on its own, and
+an index at the end of the file gives the time and the position of every block,
+so that a single block can be decoded without reading the whole file.
+
+Layout (little endian) :
+ header : "DCTB", version (u8), codec (u8), 0 (u16), states per block (u32),
+          block count (u32), index offset (u64)
+ blocks : compressed data
+ index  : per block first time (f64), offset (u64), compressed size (u32),
+          raw size (u32), state count (u32)
+ states : per state time (f64), score (f64), remaining area (f64), since the
+          version 2, so that the scores can be plotted without any decoding
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef BLOCKFILE_H
+#define BLOCKFILE_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "state.h"
+#include "saxreader.h"
+
+const unsigned STATES_PER_BLOCK = 64;
+
+typedef enum {
+	NO_CODEC, ZLIB_CODEC, ZSTD_CODEC, LZ4_CODEC
+} BlockCodec;
+
+struct BlockInfo {
+	double firstTime = 0.0;
+	std::uint64_t offset = 0;
+	std::uint32_t compressedSize = 0;
+	std::uint32_t rawSize = 0;
+	std::uint32_t stateCount = 0;
+};
+
+// Time and scores of a state, stored uncompressed after the index
+struct StateSummary {
+	double time = 0.0;
+	double score = 0.0;
+	double remainingArea = 0.0;
+};
+
+// Name used on the command line (none, zlib, zstd, lz4)
+std::string codecName(BlockCodec codec);
+
+// Return false if the name is not a known codec
+bool parseCodecName(const std::string &name, BlockCodec &codec);
+
+// False if the program was built without the library of the codec
+bool isCodecAvailable(BlockCodec codec);
+
+void writeBlocks(std::ostream &output, const std::vector<State> &states,
+					  BlockCodec codec, unsigned statesPerBlock = STATES_PER_BLOCK);
+
+class BlockReader {
+
+public:
+	// The stream must be opened in binary mode and stay alive with the reader
+	explicit BlockReader(std::istream &input);
+
+	// Look at the magic bytes without consuming them
+	static bool isBlockFile(std::istream &input);
+
+	BlockCodec getCodec() const { return codec; }
+
+	const std::vector<BlockInfo> &getBlocks() const { return blocks; }
+
+	// One entry per state, empty for the files written before the version 2
+	const std::vector<StateSummary> &getSummaries() const { return summaries; }
+
+	// Index of the block holding the state displayed at the given time
+	std::size_t findBlock(double time) const;
+
+	void readBlock(std::size_t index, const StateCallback &onState);
+
+	void readAll(const StateCallback &onState);
+
+private:
+	std::istream &input;
+	std::istream::pos_type start;
+	BlockCodec codec = NO_CODEC;
+	std::vector<BlockInfo> blocks;
+	std::vector<StateSummary> summaries;
+};
+
+#endif // BLOCKFILE_H
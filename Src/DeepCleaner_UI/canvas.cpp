@@ -40,22 +40,7 @@ void Canvas::DrawOnRefresh(unsigned mult, double nextStateTime) {
 	if (elapsedTime < nextStateTime) {
 		double shift = DELTA_T * mult;
 		for (Robot &robot: loadedState.getRobots()) {
-
-			if (equal(robot.getLeftSpeed(), robot.getRightSpeed())) {
-
-				if (!equal(robot.getLeftSpeed(), 0.0)) {
-					robot.setPosition(
-						updateLinCoordinate(robot.getPosition(), robot.getLeftSpeed(),
-												  robot.getAngle(), shift));
-				}
-			} else if (robot.getLeftSpeed() == -robot.getRightSpeed()) {
-
-				robot.setAngle(toDeg(
-					updateAngle(robot.getAngle(), robot.getRadius(), robot.getLeftSpeed(),
-									robot.getRightSpeed(), shift)));
-			} else {
-				updateCircCoordinate(robot, shift);
-			}
+			advanceRobot(robot, shift);
 		}
 
 
@@ -67,24 +52,47 @@ void Canvas::DrawOnRefresh(unsigned mult, double nextStateTime) {
 
 
 void Canvas::drawEvent() {
+	if (this->timelineState != nullptr) {
+		for (const Robot &robot: movedRobots) {
+			robot.draw(this, timelineState->getWorldOrigin(), this->ratio);
+		}
+		for (const Particle &particle: timelineState->getParticles()) {
+			particle.draw(this, timelineState->getWorldOrigin(), this->ratio);
+		}
+		return;
+	}
 
-	for (Robot &robot: loadedState.getRobots()) {
+	for (const Robot &robot: loadedState.getRobots()) {
 		robot.draw(this, loadedState.getWorldOrigin(), this->ratio);
 	}
-	for (Particle &particle: loadedState.getParticles()) {
+	for (const Particle &particle: loadedState.getParticles()) {
 		particle.draw(this, loadedState.getWorldOrigin(), this->ratio);
 	}
 }
 
 
-void Canvas::updateState(State *state) {
-	State copyState = *state;
-	if (copyState.getTime() < this->loadedState.getTime()) {
+void Canvas::displayAt(StatePointer state, double time) {
+	if (state != this->timelineState) {
+		this->timelineState = state;
+		setBaseSize(state->getWorldEnd().getX() - state->getWorldOrigin().getX());
+		this->ratio = (double) this->newSize / this->baseSize;
+	}
+	// Only the robots move between two states, restart from the stored ones
+	this->movedRobots = state->getRobots();
+	for (Robot &robot: movedRobots) {
+		advanceRobot(robot, time - state->getTime());
+	}
+	this->update();
+}
+
+void Canvas::updateState(const State *state) {
+	this->timelineState.reset();
+	if (state->getTime() < this->loadedState.getTime()) {
 		this->elapsedTime = this->loadedState.getTime();
 	} else {
-		this->elapsedTime = copyState.getTime();
+		this->elapsedTime = state->getTime();
 	}
-	this->loadedState = copyState;
+	this->loadedState = *state;
 	double finalSize =
 		loadedState.getWorldEnd().getX() - loadedState.getWorldOrigin().getX();
 	setBaseSize(finalSize);
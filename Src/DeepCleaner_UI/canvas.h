@@ -25,7 +25,7 @@ public:
 
 public
 	slots:
-		void updateState(State * state);
+		void updateState(const State * state);
 
 	void updateSize(QSize size);
 
@@ -33,11 +33,16 @@ public
 
 	void drawEvent();
 
+	// Display a state owned by a timeline, moved to the given time
+	void displayAt(StatePointer state, double time);
+
 
 private:
 	State loadedState;
+	StatePointer timelineState; // shared with the timeline, drawn with movedRobots
+	std::vector<Robot> movedRobots;
 	int baseSize = 500;
-	int newSize;
+	int newSize = 500;
 	double elapsedTime = 0;
 
 	void setBaseSize(int size);
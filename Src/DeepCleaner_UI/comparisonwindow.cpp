@@ -0,0 +1,187 @@
+/*-----------------------------------------------------------------------------
+File name : comparisonwindow.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the comparison window
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <QDoubleSpinBox>
+#include <QFileInfo>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QResizeEvent>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include "comparisonwindow.h"
+#include "canvas.h"
+#include "scoreplot.h"
+
+const int FRAME_INTERVAL_MS = 1000 / 24;
+const int CONTROLS_HEIGHT = 200; // space taken by the buttons and the plot
+
+ComparisonWindow::ComparisonWindow(const QStringList &paths, QWidget *parent)
+	: QWidget{parent} {
+	setWindowTitle("Timelines comparison");
+
+	// Playback controls, same as the main window
+	QPushButton *resetButton = new QPushButton(" |<-", this);
+	startButton = new QPushButton(" |>", this);
+	startButton->setCheckable(true);
+	timeBox = new QDoubleSpinBox(this);
+	timeBox->setDecimals(3);
+	timeBox->setSuffix(" sec");
+	speedBox = new QSpinBox(this);
+	speedBox->setRange(1, 10);
+	speedBox->setSuffix(" x");
+
+	QHBoxLayout *controls = new QHBoxLayout();
+	controls->addWidget(resetButton);
+	controls->addWidget(startButton);
+	controls->addWidget(new QLabel("Time :", this));
+	controls->addWidget(timeBox);
+	controls->addWidget(new QLabel("Speed :", this));
+	controls->addWidget(speedBox);
+	controls->addStretch();
+
+	// One canvas per timeline, as square as possible
+	double count = std::max(1.0, double(paths.size()));
+	columns = unsigned(std::ceil(std::sqrt(count)));
+	rows = (unsigned(paths.size()) + columns - 1) / columns;
+	QGridLayout *grid = new QGridLayout();
+	views.resize(paths.size());
+	for (unsigned i = 0; i < views.size(); ++i) {
+		View &view = views[i];
+		std::string path = paths[i].toStdString();
+		view.name = QFileInfo(paths[i]).fileName();
+		// Compressed timelines only read their index and decode their blocks on
+		// demand, the plain ones are still parsed whole. The views compare runs
+		// of the same scenario, so they share its initial state
+		loaders.start([this, i, path]() {
+			std::shared_ptr<Timeline> loaded;
+			QString error;
+			try {
+				loaded = std::make_shared<Timeline>(path, &initialStates);
+			}
+			catch (std::exception &e) {
+				error = e.what();
+			}
+			QMetaObject::invokeMethod(this, [=]() {
+				timelineLoaded(i, loaded, error);
+			}, Qt::QueuedConnection);
+		});
+
+		view.label = new QLabel(view.name + " : loading...", this);
+		view.canvas = new Canvas(this);
+		view.canvas->setMinimumSize(200, 200);
+		view.canvas->setStyleSheet("background-color:\"darkgray\";");
+		QVBoxLayout *cell = new QVBoxLayout();
+		cell->addWidget(view.label);
+		cell->addWidget(view.canvas, 1);
+		grid->addLayout(cell, int(i / columns), int(i % columns));
+	}
+
+	plot = new ScorePlot(this);
+
+	QVBoxLayout *layout = new QVBoxLayout(this);
+	layout->addLayout(controls);
+	layout->addLayout(grid, 1);
+	layout->addWidget(plot);
+
+	connect(resetButton, &QPushButton::released, this, &ComparisonWindow::reset);
+	connect(startButton, &QPushButton::toggled, this,
+			  &ComparisonWindow::togglePlayback);
+	connect(timeBox, &QDoubleSpinBox::editingFinished, this,
+			  &ComparisonWindow::seek);
+
+	// A single clock drives the playback and all the canvases
+	clock = new QTimer(this);
+	connect(clock, &QTimer::timeout, this, &ComparisonWindow::tick);
+	clock->start(FRAME_INTERVAL_MS);
+}
+
+void ComparisonWindow::timelineLoaded(unsigned index,
+													 std::shared_ptr<Timeline> timeline,
+													 const QString &error) {
+	View &view = views[index];
+	if (timeline == nullptr) {
+		view.label->setText(view.name + " : " + error);
+		return;
+	}
+	if (timeline->isEmpty()) {
+		view.label->setText(view.name + " : empty timeline");
+		return;
+	}
+	view.timeline = std::move(timeline);
+
+	const std::vector<double> &times = view.timeline->getTimes();
+	std::vector<QPointF> scores;
+	scores.reserve(times.size());
+	for (size_t j = 0; j < times.size(); ++j)
+		scores.emplace_back(times[j], view.timeline->getScores()[j].score);
+	plot->setSeries(index, view.name, std::move(scores));
+
+	endTime = std::max(endTime, view.timeline->getEndTime());
+	timeBox->setMaximum(endTime);
+	displayTime(time);
+}
+
+void ComparisonWindow::tick() {
+	if (!playing)
+		return;
+
+	// Advance with the real elapsed time so that slow frames do not drift
+	double newTime = time + wallClock.restart() / 1000.0 * speedBox->value();
+	if (newTime >= endTime) {
+		newTime = endTime;
+		startButton->setChecked(false);
+	}
+	displayTime(newTime);
+}
+
+void ComparisonWindow::displayTime(double newTime) {
+	this->time = newTime;
+	for (View &view: views) {
+		if (!view.timeline)
+			continue;
+		const ScoreEntry &score = view.timeline->getScoreAt(newTime);
+		view.canvas->displayAt(view.timeline->getStateAt(newTime), newTime);
+		view.label->setText(view.name + " : score " +
+								  QString::number(score.score, 'f', 0));
+	}
+	timeBox->setValue(newTime);
+	plot->setCurrentTime(newTime);
+}
+
+void ComparisonWindow::togglePlayback(bool checked) {
+	playing = checked && endTime > 0.0;
+	if (playing) {
+		wallClock.start();
+		startButton->setText("| |");
+	} else {
+		startButton->setText("|>");
+	}
+}
+
+void ComparisonWindow::reset() {
+	startButton->setChecked(false);
+	displayTime(0.0);
+}
+
+void ComparisonWindow::seek() {
+	displayTime(timeBox->value());
+	if (playing)
+		wallClock.restart();
+}
+
+void ComparisonWindow::resizeEvent(QResizeEvent *event) {
+	QWidget::resizeEvent(event);
+	QSize cell(width() / int(columns),
+				  std::max(0, height() - CONTROLS_HEIGHT) / int(rows));
+	for (View &view: views)
+		view.canvas->updateSize(cell);
+}
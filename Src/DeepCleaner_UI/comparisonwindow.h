@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------------
+File name : comparisonwindow.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the window playing several timelines side by side,
+driven by a single playback clock, with their scores over time
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef COMPARISONWINDOW_H
+#define COMPARISONWINDOW_H
+
+#include <memory>
+#include <vector>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWidget>
+#include "timeline.h"
+
+class Canvas;
+class QDoubleSpinBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class ScorePlot;
+
+class ComparisonWindow : public QWidget {
+	Q_OBJECT
+
+public:
+	explicit ComparisonWindow(const QStringList &paths, QWidget *parent = nullptr);
+
+private
+	slots:
+		void tick();
+
+	void togglePlayback(bool checked);
+
+	void reset();
+
+	void seek();
+
+protected:
+	void resizeEvent(QResizeEvent *event) override;
+
+private:
+	struct View {
+		QString name;
+		std::shared_ptr<Timeline> timeline; // null until loaded
+		Canvas *canvas = nullptr;
+		QLabel *label = nullptr;
+	};
+
+	// Declared first, the views loading in the background use it
+	StatePool initialStates;
+	std::vector<View> views;
+	unsigned columns = 1, rows = 1;
+
+	// Declared after the states and views, its destruction waits for the loads
+	QThreadPool loaders;
+
+	QTimer *clock;
+	QElapsedTimer wallClock;
+	bool playing = false;
+	double time = 0.0;
+	double endTime = 0.0;
+
+	QPushButton *startButton;
+	QDoubleSpinBox *timeBox;
+	QSpinBox *speedBox;
+	ScorePlot *plot;
+
+	void timelineLoaded(unsigned index, std::shared_ptr<Timeline> timeline,
+							  const QString &error);
+
+	void displayTime(double newTime);
+};
+
+#endif // COMPARISONWINDOW_H
@@ -0,0 +1,39 @@
+/*-----------------------------------------------------------------------------
+File name : fileformat.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the encodings available for the state and timeline
+files. The encoding of a file is detected from its first bytes when reading.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef FILEFORMAT_H
+#define FILEFORMAT_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include "json.hpp"
+
+typedef enum {
+	JSON_PRETTY, JSON_COMPACT, CBOR, MSGPACK, BSON
+} FileFormat;
+
+// Name used on the command line (json, compact, cbor, msgpack, bson)
+std::string formatName(FileFormat format);
+
+// Return false if the name is not a known format
+bool parseFormatName(const std::string &name, FileFormat &format);
+
+bool isBinaryFormat(FileFormat format);
+
+void writeDocument(std::ostream &os, const nlohmann::json &document,
+						 FileFormat format);
+
+// Look at the first bytes without consuming them, the stream must be seekable.
+// Both json formats are reported as JSON_PRETTY
+FileFormat detectFormat(std::istream &input);
+
+nlohmann::json::input_format_t toInputFormat(FileFormat format);
+
+#endif // FILEFORMAT_H
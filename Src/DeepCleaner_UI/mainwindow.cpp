@@ -6,12 +6,16 @@ Description :  Implementation of the mainwindow functions and events
 Compiler : Mingw-w64 g++ 11.2.0
 -----------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <iostream>
+#include <QDockWidget>
 #include <QFileDialog>
 #include <QDebug>
 #include <QMessageBox>
 #include "mainwindow.h"
 #include "canvas.h"
+#include "comparisonwindow.h"
+#include "scoreplot.h"
 #include "ui_mainwindow.h"
 #include "math.h"
 
@@ -21,7 +25,13 @@ Compiler : Mingw-w64 g++ 11.2.0
 
 using Qmb = QMessageBox;
 
-QString calculateScore(std::vector<Robot> robots, std::vector<Particle> particles);
+// Save dialog filters, in the order of the FileFormat values
+const QStringList STATE_FILTERS = QStringList()
+	<< "State file (*.stat)" << "Compact state file (*.stat)"
+	<< "CBOR state file (*.stat)" << "MessagePack state file (*.stat)"
+	<< "BSON state file (*.stat)";
+
+QString scoreText(const ScoreEntry &entry);
 
 
 MainWindow::MainWindow(QWidget *parent)
@@ -31,6 +41,12 @@ MainWindow::MainWindow(QWidget *parent)
 	elapsedTime = 0.0;
 	timer = new QTimer(this);
 
+	// Score over time, below the canvas
+	scorePlot = new ScorePlot(this);
+	QDockWidget *scoreDock = new QDockWidget("Score over time", this);
+	scoreDock->setWidget(scorePlot);
+	addDockWidget(Qt::BottomDockWidgetArea, scoreDock);
+
 	// Events connection
 	connect(this, &MainWindow::sendToCanvas, ui->frame, &Canvas::updateState);
 	connect(this, &MainWindow::resizeCanvas, ui->frame, &Canvas::updateSize);
@@ -121,9 +137,9 @@ void MainWindow::on_actionOpen_state_triggered() {
 
 	//Reset the timer and display the state
 	this->elapsedTime = 0.0;
-	displayState(&this->state);
-
 	currentlyLoaded = STATE;
+	scorePlot->clear();
+	displayState(&this->state);
 
 	//Only enable the "save state" button
 	enableButtons(false, false, false, true);
@@ -156,26 +172,59 @@ void MainWindow::on_actionOpen_timeline_triggered() {
 
 	//Initialize the timeline
 	this->timeline.setCurrentState(0);
-	this->ui->Score_Display->setText(
-		calculateScore(this->timeline.getCurrentState()->getRobots(),
-							this->timeline.getCurrentState()->getParticles()));
-	displayState(this->timeline.getCurrentState());
+	currentlyLoaded = TIMELINE;
+
+	//Plot the score precomputed by the timeline
+	std::vector<QPointF> scores;
+	scores.reserve(this->timeline.getScores().size());
+	for (size_t i = 0; i < this->timeline.getScores().size(); ++i) {
+		scores.emplace_back(this->timeline.getTimes()[i],
+								  this->timeline.getScores()[i].score);
+	}
+	scorePlot->clear();
+	scorePlot->setSeries(0, fileName, std::move(scores));
+
+	displayState(this->timeline.getCurrentState().get());
 
 
 	//Enable all the buttons only if the file has been loaded
 	enableButtons(true);
 
 	//Set the maximum time of the counter
-	ui->doubleSpinBox->setMaximum(timeline.getLastState()->getTime());
-	currentlyLoaded = TIMELINE;
+	ui->doubleSpinBox->setMaximum(timeline.getEndTime());
 }
 
-void MainWindow::saveCurrentState() {
+void MainWindow::on_actionCompare_timelines_triggered() {
+	QStringList filePaths = QFileDialog::getOpenFileNames(this,
+																			"open the timelines to compare",
+																			jsonDir.path(),
+																			tr("Timeline file (*.tlin)"));
+	// The window has been closed -> do nothing
+	if (filePaths.isEmpty())
+		return;
+
+	// The window loads the timelines by itself and is freed when closed
+	ComparisonWindow *comparison = new ComparisonWindow(filePaths);
+	comparison->setAttribute(Qt::WA_DeleteOnClose);
+	comparison->resize(this->width() * 2, this->height());
+	comparison->show();
+}
+
+QString MainWindow::getStateSavePath(FileFormat &format) {
+	QString selectedFilter = STATE_FILTERS.front();
 	QString fileName = QFileDialog::getSaveFileName(this, "Save the state",
 																	jsonDir.path(),
-																	tr("State file (*.stat)"));
+																	STATE_FILTERS.join(";;"),
+																	&selectedFilter);
+	format = FileFormat(std::max(0, int(STATE_FILTERS.indexOf(selectedFilter))));
+	return fileName;
+}
+
+void MainWindow::saveCurrentState() {
+	FileFormat format;
+	QString fileName = getStateSavePath(format);
 	try {
-		this->state.serialize(fileName.toStdString());
+		this->state.serialize(fileName.toStdString(), format);
 	}
 	catch (std::exception &e) {
 		displaySerializeError(e);
@@ -183,11 +232,9 @@ void MainWindow::saveCurrentState() {
 }
 
 void MainWindow::saveCurrentStateFromTimeline() {
-	QString fileName = QFileDialog::getSaveFileName(this, "Save the state",
-																	jsonDir.path(),
-																	tr("State file (*.stat)"));
-	this->state = *this->timeline.getCurrentState();
-	this->state.serialize(fileName.toStdString());
+	FileFormat format;
+	QString fileName = getStateSavePath(format);
+	this->timeline.getCurrentState()->serialize(fileName.toStdString(), format);
 }
 
 void MainWindow::on_actionSave_state_triggered() {
@@ -216,22 +263,25 @@ void MainWindow::on_doubleSpinBox_editingFinished() {
 	// Set the state corresponding to the value & display
 	if (!this->timeline.isEmpty()) {
 		this->timeline.setCurrentState(this->elapsedTime);
-		displayState(this->timeline.getCurrentState());
+		displayState(this->timeline.getCurrentState().get());
 	}
 }
 
-void MainWindow::displayState(State *state) {
-	this->ui->Score_Display->setText(
-		calculateScore(this->timeline.getCurrentState()->getRobots(),
-							this->timeline.getCurrentState()->getParticles()));
+void MainWindow::displayState(const State *state) {
+	// The scores of a timeline are computed once, when it is loaded
+	if (currentlyLoaded == TIMELINE && state == this->timeline.getCurrentState().get())
+		this->ui->Score_Display->setText(scoreText(this->timeline.getCurrentScore()));
+	else
+		this->ui->Score_Display->setText(scoreText(state->getScore()));
+	scorePlot->setCurrentTime(state->getTime());
 	emit sendToCanvas(state);
 	emit
-	this->resizeCanvas(QSize(this->width(), this->height()));
+	this->resizeCanvas(ui->centralwidget->size());
 }
 
 void MainWindow::timerUpdate() {
 	// Check that the timer is stopped after displaying the last state
-	if (this->elapsedTime < this->timeline.getLastState()->getTime()) {
+	if (this->elapsedTime < this->timeline.getEndTime()) {
 
 		//Increment & display the time
         if (int((elapsedTime / ui->spinBox->value()) * 1000) % 42 == 0) {
@@ -250,7 +300,7 @@ void MainWindow::timerUpdate() {
 	//Update the states in the timeline & display it
 	if (this->elapsedTime >= this->timeline.getNextState()->getTime()) {
 		this->timeline.setNextState();
-		displayState(this->timeline.getCurrentState());
+		displayState(this->timeline.getCurrentState().get());
 
 	}
 }
@@ -266,7 +316,7 @@ void MainWindow::on_ResetButton_released() {
 	//Reset the timeline & display the first state
 	if (!this->timeline.isEmpty()) {
 		this->timeline.setCurrentState(0);
-		displayState(this->timeline.getCurrentState());
+		displayState(this->timeline.getCurrentState().get());
 	}
 }
 
@@ -278,7 +328,7 @@ void MainWindow::on_StartButton_toggled(bool checked) {
 			timer->start(1);
 			ui->doubleSpinBox->setValue(this->elapsedTime);
 			this->timeline.setCurrentState(this->elapsedTime);
-			displayState(this->timeline.getCurrentState());
+			displayState(this->timeline.getCurrentState().get());
 
 			// Change the button text
 			ui->StartButton->setText("| |");
@@ -296,21 +346,11 @@ void MainWindow::resizeEvent(QResizeEvent *event) {
 	this->setMinimumHeight(ui->frame->y() + 250);
 	this->setMinimumWidth(ui->frame->x() + 250);
 	emit
-	this->resizeCanvas(QSize(this->width(), this->height()));
+	this->resizeCanvas(ui->centralwidget->size());
 }
 
-QString calculateScore(std::vector<Robot> robots, std::vector<Particle> particles) {
-	int totalScore = 0;
-	int scoreLeft = 0;
-
-	for (Robot r: robots) {
-		totalScore += r.getScore();
-	}
-	for (Particle p: particles) {
-		scoreLeft += p.getRadius() * p.getRadius() * M_PI;
-	}
-	QString ssl = QString::number(scoreLeft);
-	QString sts = QString::number(totalScore);
-	QString text = QString("%1 / %2").arg(sts, ssl);
-	return text;
+QString scoreText(const ScoreEntry &entry) {
+	QString sts = QString::number(entry.score, 'f', 0);
+	QString ssl = QString::number(entry.remainingArea, 'f', 0);
+	return QString("%1 / %2").arg(sts, ssl);
 }
@@ -19,6 +19,8 @@ QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
+class ScorePlot;
+
 enum CurrentlyLoaded {
 	NONE, STATE, TIMELINE
 };
@@ -31,7 +33,7 @@ public:
 
 	~MainWindow();
 
-	void displayState(State *state);
+	void displayState(const State *state);
 
 private
 	slots:
@@ -41,6 +43,8 @@ private
 
 	void on_actionOpen_timeline_triggered();
 
+	void on_actionCompare_timelines_triggered();
+
 	void on_actionSave_state_triggered();
 
 	void on_doubleSpinBox_editingFinished();
@@ -52,7 +56,7 @@ private
 	void on_StartButton_toggled(bool checked);
 
 	signals:
-		void sendToCanvas(State * state);
+		void sendToCanvas(const State * state);
 
 	void resizeCanvas(QSize size);
 
@@ -61,6 +65,7 @@ private
 private:
 	Ui::MainWindow *ui;
 	QTimer *timer;
+	ScorePlot *scorePlot;
 	double elapsedTime;
 	Timeline timeline;
 	State state;
@@ -90,6 +95,9 @@ private:
 
 	void saveCurrentState();
 
+	// Ask the path of the state to save and the format chosen in the filter
+	QString getStateSavePath(FileFormat &format);
+
 	CurrentlyLoaded currentlyLoaded;
 };
 
@@ -0,0 +1,126 @@
+/*-----------------------------------------------------------------------------
+File name : offscreenrenderer.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the offscreen renderer
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <QDir>
+#include <QPainter>
+#include <QThreadPool>
+#include "offscreenrenderer.h"
+#include "trajectory.h"
+
+// Same color as the canvas of the main window
+const QColor OffscreenRenderer::background = QColor(169, 169, 169);
+
+// Number of frames given to each worker between two writes of the raw stream
+const int FRAMES_PER_WORKER = 4;
+
+OffscreenRenderer::OffscreenRenderer(const Timeline &timeline,
+												 const RenderSettings &settings)
+	: timeline(timeline), settings(settings) {
+	this->settings.threads = std::max(1u, settings.threads);
+	StatePointer first = timeline.getStateAt(0.0);
+	if (first == nullptr)
+		return;
+
+	worldOrigin = first->getWorldOrigin();
+	double worldWidth = first->getWorldEnd().getX() - worldOrigin.getX();
+	double worldHeight = first->getWorldEnd().getY() - worldOrigin.getY();
+	if (worldWidth > 0 && worldHeight > 0) {
+		ratio = std::min(settings.frameSize.width() / worldWidth,
+							  settings.frameSize.height() / worldHeight);
+	}
+	frames = int(timeline.getEndTime() * settings.fps) + 1;
+}
+
+QImage OffscreenRenderer::renderFrame(int frame) const {
+	QImage image(settings.frameSize, QImage::Format_RGB32);
+	image.fill(background);
+
+	double time = double(frame) / settings.fps;
+	StatePointer state = timeline.getStateAt(time);
+	if (state == nullptr)
+		return image;
+
+	// Only the robots move between two states, the particles are drawn as is.
+	// The frames before the first state show it as is
+	double deltaTime = std::max(0.0, time - state->getTime());
+	for (Robot robot: state->getRobots()) {
+		advanceRobot(robot, deltaTime);
+		robot.draw(&image, worldOrigin, ratio);
+	}
+	for (const Particle &particle: state->getParticles()) {
+		particle.draw(&image, worldOrigin, ratio);
+	}
+	return image;
+}
+
+void OffscreenRenderer::forEachFrame(int first, int last,
+												 const std::function<void(int)> &job) const {
+	int count = last - first;
+	int workers = std::min<int>(settings.threads, count);
+	if (workers <= 1) {
+		for (int frame = first; frame < last; ++frame)
+			job(frame);
+		return;
+	}
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(workers);
+	for (int w = 0; w < workers; ++w) {
+		int begin = first + count * w / workers;
+		int end = first + count * (w + 1) / workers;
+		pool.start([=, &job]() {
+			for (int frame = begin; frame < end; ++frame)
+				job(frame);
+		});
+	}
+	pool.waitForDone();
+}
+
+bool OffscreenRenderer::renderToPng(const QString &directory) const {
+	QDir dir(directory);
+	if (!dir.exists() && !dir.mkpath("."))
+		return false;
+
+	std::atomic<bool> success(true);
+	forEachFrame(0, frames, [&](int frame) {
+		QString name = QString("frame_%1.png").arg(frame, 6, 10, QChar('0'));
+		if (!renderFrame(frame).save(dir.filePath(name), "PNG"))
+			success = false;
+	});
+	return success;
+}
+
+bool OffscreenRenderer::renderToRaw(std::FILE *output) const {
+	int batchSize = int(settings.threads) * FRAMES_PER_WORKER;
+	std::vector<QImage> batch(batchSize);
+	size_t lineSize = size_t(settings.frameSize.width()) * 3;
+
+	for (int first = 0; first < frames; first += batchSize) {
+		int last = std::min(first + batchSize, frames);
+
+		// Render the batch in parallel...
+		forEachFrame(first, last, [&](int frame) {
+			batch[frame - first] = renderFrame(frame).convertToFormat(
+				QImage::Format_RGB888);
+		});
+
+		// ...and write it in order, without the scan line padding
+		for (int i = 0; i < last - first; ++i) {
+			const QImage &image = batch[i];
+			for (int y = 0; y < image.height(); ++y) {
+				if (std::fwrite(image.constScanLine(y), 1, lineSize, output)
+					 != lineSize)
+					return false;
+			}
+		}
+	}
+	return std::fflush(output) == 0;
+}
@@ -0,0 +1,56 @@
+/*-----------------------------------------------------------------------------
+File name : offscreenrenderer.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the class rendering a timeline on images without any
+window. It reuses the drawing code of the robots and particles.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef OFFSCREENRENDERER_H
+#define OFFSCREENRENDERER_H
+
+#include <cstdio>
+#include <functional>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include "timeline.h"
+
+struct RenderSettings {
+	QSize frameSize = QSize(1920, 1080);
+	int fps = 24;
+	unsigned threads = 1;
+};
+
+class OffscreenRenderer {
+
+public:
+	OffscreenRenderer(const Timeline &timeline, const RenderSettings &settings);
+
+	int frameCount() const { return frames; }
+
+	// Draw the world at the time of the given frame
+	QImage renderFrame(int frame) const;
+
+	// Save every frame as <directory>/frame_000000.png
+	bool renderToPng(const QString &directory) const;
+
+	// Write every frame in order as packed rgb24 pixels
+	bool renderToRaw(std::FILE *output) const;
+
+private:
+	static const QColor background;
+
+	const Timeline &timeline;
+	RenderSettings settings;
+	Position worldOrigin;
+	double ratio = 1.0;
+	int frames = 0;
+
+	// Split [first, last[ in contiguous ranges, one per thread of a local pool
+	void forEachFrame(int first, int last,
+							const std::function<void(int frame)> &job) const;
+};
+
+#endif // OFFSCREENRENDERER_H
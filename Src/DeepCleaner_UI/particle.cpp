@@ -17,10 +17,10 @@ Particle::Particle(int id, Position position, double radius,
 	this->id = id;
 	this->position = position;
 	this->radius = radius;
-	this->explosionTimes = explosionTimes;
+	this->explosionTimes = std::move(explosionTimes);
 }
 
-void Particle::draw(QPaintDevice *device, Position worldOrigin, double ratio) {
+void Particle::draw(QPaintDevice *device, Position worldOrigin, double ratio) const {
 	QPainter p(device);
 	p.setRenderHint(QPainter::Antialiasing, QPainter::SmoothPixmapTransform);
 	double ratioedRadius = this->radius * ratio;
@@ -24,9 +24,13 @@ public:
 	Particle() : id(0), position(Position()), radius(0), explosionTimes
 		(std::vector<std::vector<double>>()) {}
 
-	void draw(QPaintDevice *device, Position worldOrigin, double ratio);
+	void draw(QPaintDevice *device, Position worldOrigin, double ratio) const;
 
-	double getRadius() { return radius; };
+	const Position &getPosition() const { return position; }
+
+	double getRadius() const { return radius; }
+
+	int getId() const { return id; }
 	signals:
 
 private:
@@ -18,9 +18,9 @@ public:
 
 	Position(double x, double y);
 
-	double getX();
+	double getX() const { return x; }
 
-	double getY();
+	double getY() const { return y; }
 
 	void setX(double _x) { this->x = _x; }
 
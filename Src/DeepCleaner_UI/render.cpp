@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------------
+File name : render.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Headless entry point rendering a timeline to a PNG sequence or
+to a raw rgb24 stream that can be piped to an encoder, e.g.
+ DeepCleaner_Render 05.tlin -o - | ffmpeg -f rawvideo -pix_fmt rgb24
+ -s 1920x1080 -r 24 -i - 05.mp4
+
+Command line arguments: DeepCleaner_Render <Timeline path> [-o <Directory | ->]
+ [-s <Width>x<Height>] [-r <Frames per second>] [-j <Threads>]
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QThread>
+#include "offscreenrenderer.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+int main(int argc, char *argv[]) {
+	// No window is ever shown, the platform does not need a display
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QGuiApplication app(argc, argv);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Render a timeline without opening a window");
+	parser.addHelpOption();
+	parser.addPositionalArgument("timeline", "Timeline file (*.tlin) to render");
+	QCommandLineOption outputOpt(QStringList() << "o" << "output",
+										  "Directory of the PNG frames, - for raw rgb24 "
+										  "frames on the standard output", "path",
+										  "frames");
+	QCommandLineOption sizeOpt(QStringList() << "s" << "size",
+										"Size of the frames", "WxH", "1920x1080");
+	QCommandLineOption fpsOpt(QStringList() << "r" << "fps",
+									  "Frames per second", "fps", "24");
+	QCommandLineOption threadsOpt(QStringList() << "j" << "threads",
+											"Number of render threads", "n",
+											QString::number(std::max(
+												1u, unsigned(QThread::idealThreadCount()))));
+	parser.addOptions({outputOpt, sizeOpt, fpsOpt, threadsOpt});
+	parser.process(app);
+
+	if (parser.positionalArguments().size() != 1)
+		parser.showHelp(EXIT_FAILURE);
+
+	RenderSettings settings;
+	QStringList size = parser.value(sizeOpt).split('x');
+	bool widthOk = false, heightOk = false, fpsOk = false, threadsOk = false;
+	if (size.size() == 2)
+		settings.frameSize = QSize(size[0].toInt(&widthOk), size[1].toInt(&heightOk));
+	settings.fps = parser.value(fpsOpt).toInt(&fpsOk);
+	settings.threads = parser.value(threadsOpt).toUInt(&threadsOk);
+	if (!widthOk || !heightOk || settings.frameSize.isEmpty() || !fpsOk ||
+		 settings.fps <= 0 || !threadsOk) {
+		std::cerr << "Invalid size, fps or threads value\n";
+		return EXIT_FAILURE;
+	}
+
+	QString output = parser.value(outputOpt);
+	int frames = 0;
+	bool success;
+	// Rendering and writing only, the timeline is read before
+	qint64 renderTime = 0;
+	try {
+		Timeline timeline(parser.positionalArguments().first().toStdString());
+		OffscreenRenderer renderer(timeline, settings);
+		frames = renderer.frameCount();
+		QElapsedTimer timer;
+		timer.start();
+		if (output == "-") {
+#ifdef _WIN32
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			success = renderer.renderToRaw(stdout);
+		} else {
+			success = renderer.renderToPng(output);
+		}
+		renderTime = timer.nsecsElapsed();
+	}
+	catch (std::exception &e) {
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	if (!success) {
+		std::cerr << "Could not write the frames to " << output.toStdString() << '\n';
+		return EXIT_FAILURE;
+	}
+	// Faster than real time when the frames per second are above settings.fps
+	double seconds = double(renderTime) * 1e-9;
+	std::cerr << frames << " frames rendered in " << seconds << " sec";
+	if (frames > 0 && seconds > 0) {
+		std::cerr << ", " << seconds * 1000 / frames << " ms per frame, "
+					 << frames / seconds << " frames per second for "
+					 << settings.fps << " in real time";
+	}
+	std::cerr << '\n';
+	return EXIT_SUCCESS;
+}
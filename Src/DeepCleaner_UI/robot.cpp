@@ -36,7 +36,7 @@ double Robot::getAngle(AngleUnit unit) const {
 	return this->angle;
 }
 
-void Robot::draw(QPaintDevice *device, Position worldOrigin, double ratio) {
+void Robot::draw(QPaintDevice *device, Position worldOrigin, double ratio) const {
 	double ratioedRadius = this->radius * ratio;
 	double diameter = ratioedRadius * 2;
 	double textSize = diameter / 2 * ratio;
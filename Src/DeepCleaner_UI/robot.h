@@ -43,7 +43,7 @@ public:
 
 	double getAngle(AngleUnit unit = RAD) const;
 
-	Position getPosition() const { return position; }
+	const Position &getPosition() const { return position; }
 
 	double getRadius() const { return radius; }
 
@@ -53,13 +53,15 @@ public:
 
 	int getId() const { return id; }
 
-	int getScore() const { return score; }
+	double getScore() const { return score; }
 
 	void setPosition(Position pos) { position = pos; }
 
 	void setAngle(double _angle) { angle = _angle; }
 
-	void draw(QPaintDevice *device, Position worldOrigin, double ratio);
+	void setScore(double newScore) { score = newScore; }
+
+	void draw(QPaintDevice *device, Position worldOrigin, double ratio) const;
 
 private:
 	static const QBrush background;
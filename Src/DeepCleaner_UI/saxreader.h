@@ -0,0 +1,127 @@
+/*-----------------------------------------------------------------------------
+File name : saxreader.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the streaming reader of the state and timeline files.
+The objects are built directly from the parser events, without any json tree.
+A missing field is an error, as with the json reader of the model classes.
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef SAXREADER_H
+#define SAXREADER_H
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "state.h"
+#include "json.hpp"
+
+using StateCallback = std::function<void(State &&state)>;
+
+class ModelSaxReader : public nlohmann::json_sax<nlohmann::json> {
+
+public:
+	explicit ModelSaxReader(StateCallback onState) : onState(std::move(onState)) {}
+
+	// True if the root object held a "states" array
+	bool isTimeline() const { return timeline; }
+
+	bool null() override { return true; }
+
+	bool boolean(bool) override { return true; }
+
+	bool number_integer(number_integer_t val) override { return number(double(val)); }
+
+	bool number_unsigned(number_unsigned_t val) override { return number(double(val)); }
+
+	bool number_float(number_float_t val, const string_t &) override { return number(val); }
+
+	bool string(string_t &) override { return true; }
+
+	bool binary(binary_t &) override { return true; }
+
+	bool start_object(std::size_t) override;
+
+	bool key(string_t &val) override;
+
+	bool end_object() override;
+
+	bool start_array(std::size_t) override;
+
+	bool end_array() override;
+
+	bool parse_error(std::size_t position, const std::string &lastToken,
+						  const nlohmann::detail::exception &ex) override;
+
+private:
+	enum class Context {
+		ROOT, STATES, STATE, ROBOTS, ROBOT, PARTICLES, PARTICLE, POSITION,
+		EXPLOSION_TIMES, GENERATION, SKIP
+	};
+
+	enum class Field {
+		NONE, STATES, TIME, WORLD_ORIGIN, WORLD_END, ROBOTS, PARTICLES, ID,
+		POSITION, RADIUS, ANGLE, CAPTURE_ANGLE, LEFT_SPEED, RIGHT_SPEED, SCORE,
+		EXPLOSION_TIMES, X, Y
+	};
+
+	struct Frame {
+		Context context;
+		Field field = Field::NONE; // last key read in this object
+		unsigned seen = 0;         // bit of every field read in it
+	};
+
+	struct StateFields {
+		double time = 0.0;
+		Position worldOrigin, worldEnd;
+		std::vector<Robot> robots;
+		std::vector<Particle> particles;
+	};
+
+	struct RobotFields {
+		int id = 0;
+		Position position;
+		double radius = 0, angle = 0, captureAngle = 0;
+		double leftSpeed = 0, rightSpeed = 0, score = 0;
+	};
+
+	struct ParticleFields {
+		int id = 0;
+		Position position;
+		double radius = 0;
+		std::vector<std::vector<double>> explosionTimes;
+	};
+
+	StateCallback onState;
+	std::vector<Frame> stack;
+	bool timeline = false;
+	StateFields state;
+	RobotFields robot;
+	ParticleFields particle;
+	Position *position = nullptr; // position being read
+
+	bool number(double val);
+
+	// The value of the current field of the object on top of the stack was read
+	void markField();
+
+	// Throw if a field of the object just read is missing
+	void checkFields(const Frame &frame) const;
+
+	void emitState();
+
+	static const std::pair<const char *, Field> FIELD_NAMES[]; // key of each field
+
+	static Field toField(const std::string &key);
+
+	static const char *fieldName(Field field);
+};
+
+// Call onState for every state of a timeline, or for the state of a state file.
+// Any of the file formats is accepted, the stream must be opened in binary mode
+void readStates(std::istream &input, const StateCallback &onState);
+
+#endif // SAXREADER_H
@@ -0,0 +1,95 @@
+/*-----------------------------------------------------------------------------
+File name : scoreplot.cpp
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Implementation of the score plot widget
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <QPainter>
+#include <QPolygonF>
+#include "scoreplot.h"
+
+const int MARGIN_LEFT = 50, MARGIN_RIGHT = 10, MARGIN_TOP = 10, MARGIN_BOTTOM = 20;
+
+ScorePlot::ScorePlot(QWidget *parent) : QWidget{parent} {
+	setMinimumHeight(120);
+}
+
+void ScorePlot::setSeries(unsigned index, const QString &name,
+								  std::vector<QPointF> points) {
+	if (index >= series.size())
+		series.resize(index + 1);
+
+	for (const QPointF &point: points) {
+		maxTime = std::max(maxTime, point.x());
+		maxScore = std::max(maxScore, point.y());
+	}
+	series[index] = {name, std::move(points)};
+	this->update();
+}
+
+void ScorePlot::clear() {
+	series.clear();
+	maxTime = maxScore = currentTime = 0.0;
+	this->update();
+}
+
+void ScorePlot::setCurrentTime(double time) {
+	this->currentTime = time;
+	this->update();
+}
+
+QColor ScorePlot::seriesColor(unsigned index) {
+	// Spread the hues so that neighbouring series are easy to tell apart
+	return QColor::fromHsv(int(index * 137) % 360, 200, 200);
+}
+
+void ScorePlot::paintEvent(QPaintEvent *event) {
+	QWidget::paintEvent(event);
+	QPainter p(this);
+	p.setRenderHint(QPainter::Antialiasing);
+
+	QRect area = rect().adjusted(MARGIN_LEFT, MARGIN_TOP, -MARGIN_RIGHT,
+										  -MARGIN_BOTTOM);
+	p.setPen(QPen(Qt::black));
+	p.drawRect(area);
+	p.drawText(QPoint(2, area.top() + 10), QString::number(maxScore, 'f', 0));
+	p.drawText(QPoint(2, area.bottom()), "0");
+	p.drawText(QPoint(area.right() - 40, area.bottom() + 15),
+				  QString::number(maxTime, 'f', 1) + " sec");
+
+	if (maxTime <= 0.0)
+		return;
+	double xScale = area.width() / maxTime;
+	double yScale = maxScore > 0.0 ? area.height() / maxScore : 0.0;
+	auto toPixel = [&](double time, double score) {
+		return QPointF(area.left() + time * xScale, area.bottom() - score * yScale);
+	};
+
+	for (unsigned i = 0; i < series.size(); ++i) {
+		const std::vector<QPointF> &points = series[i].points;
+		if (points.empty())
+			continue;
+
+		// Step curve : the score only changes at the states times
+		QPolygonF curve;
+		curve << toPixel(points.front().x(), points.front().y());
+		for (size_t j = 1; j < points.size(); ++j) {
+			curve << toPixel(points[j].x(), points[j - 1].y())
+					<< toPixel(points[j].x(), points[j].y());
+		}
+		curve << toPixel(maxTime, points.back().y());
+
+		p.setPen(QPen(seriesColor(i), 2));
+		p.drawPolyline(curve);
+		p.drawText(QPoint(area.left() + 5, area.top() + 15 * (i + 1)),
+					  series[i].name);
+	}
+
+	// Cursor on the displayed time
+	p.setPen(QPen(Qt::black, 1, Qt::DashLine));
+	double x = area.left() + std::min(currentTime, maxTime) * xScale;
+	p.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+}
@@ -0,0 +1,51 @@
+/*-----------------------------------------------------------------------------
+File name : scoreplot.h
+Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
+Creation date : 19.10.2026
+Description :  Header of the widget drawing the score of one or more timelines
+over time, with a cursor on the displayed time
+Compiler : Mingw-w64 g++ 11.2.0
+-----------------------------------------------------------------------------*/
+
+#ifndef SCOREPLOT_H
+#define SCOREPLOT_H
+
+#include <vector>
+#include <QPointF>
+#include <QString>
+#include <QWidget>
+
+class ScorePlot : public QWidget {
+	Q_OBJECT
+
+public:
+	explicit ScorePlot(QWidget *parent = nullptr);
+
+	// Points are (time, score), the score is constant until the next point
+	void setSeries(unsigned index, const QString &name,
+						std::vector<QPointF> points);
+
+	void clear();
+
+public
+	slots:
+		void setCurrentTime(double time);
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+
+private:
+	struct Series {
+		QString name;
+		std::vector<QPointF> points;
+	};
+
+	std::vector<Series> series;
+	double currentTime = 0.0;
+	double maxTime = 0.0;
+	double maxScore = 0.0;
+
+	static QColor seriesColor(unsigned index);
+};
+
+#endif // SCOREPLOT_H
@@ -6,10 +6,12 @@ Description :  Implementation of the state class
 Compiler : Mingw-w64 g++ 11.2.0
 -----------------------------------------------------------------------------*/
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include "state.h"
 #include "utils.h"
+#include "saxreader.h"
 
 State::State(const std::string &path) {
 	try {
@@ -21,31 +23,42 @@ State::State(const std::string &path) {
 	}
 }
 
-void State::serialize(const std::string &outputPath, const std::string &fileName) {
+State::State(double time, Position worldOrigin, Position worldEnd, std::vector<Robot>
+robots, std::vector<Particle> particles) {
+	this->time = time;
+	this->worldOrigin = worldOrigin;
+	this->worldEnd = worldEnd;
+	this->robots = std::move(robots);
+	this->particles = std::move(particles);
+}
+
+void State::serialize(const std::string &outputPath, const std::string &fileName) const {
 	serialize(outputPath + addExtension(fileName, this->fileExtension));
 }
 
-void State::serialize(const std::string &outputPath) {
+void State::serialize(const std::string &outputPath, FileFormat format) const {
 	std::ofstream ofs;
 	json st_j = *this;
 	try {
-		ofs.open(outputPath);
+		ofs.open(outputPath, isBinaryFormat(format) ?
+				 std::ios::out | std::ios::binary : std::ios::out);
 	}
 	catch (std::ios_base::failure &e) {
 		throw "Error creating the file \'" + outputPath + "\' : " + e.what();
 	}
-	ofs << std::setw(4) << st_j;
+	writeDocument(ofs, st_j, format);
 	ofs.close();
 }
 
 void State::deserialize(const std::string &fileName) {
-	std::ifstream f(fileName);
-	json data = json::parse(f);
-	this->time = data.get<State>().time;
-	this->worldOrigin = data.get<State>().worldOrigin;
-	this->worldEnd = data.get<State>().worldEnd;
-	this->robots = data.get<State>().robots;
-	this->particles = data.get<State>().particles;
+	std::ifstream f(fileName, std::ios::binary);
+	bool found = false;
+	// Built straight from the parser events, the first state is kept
+	readStates(f, [&](State &&s) {
+		if (!found)
+			*this = std::move(s);
+		found = true;
+	});
 }
 
 std::ostream &operator<<(std::ostream &os, const State &s) {
@@ -54,10 +67,13 @@ std::ostream &operator<<(std::ostream &os, const State &s) {
 	return os;
 }
 
-Position State::getWorldEnd() {
-	return this->worldEnd;
-}
-
-Position State::getWorldOrigin() {
-	return this->worldOrigin;
+ScoreEntry State::getScore() const {
+	ScoreEntry entry;
+	for (const Robot &r: robots) {
+		entry.score += r.getScore();
+	}
+	for (const Particle &p: particles) {
+		entry.remainingArea += p.getRadius() * p.getRadius() * M_PI;
+	}
+	return entry;
 }
@@ -9,15 +9,23 @@ Compiler : Mingw-w64 g++ 11.2.0
 #ifndef STATE_H
 #define STATE_H
 
+#include <memory>
 #include <utility>
 #include <vector>
 #include "robot.h"
 #include "particle.h"
 #include "position.h"
 #include "json.hpp"
+#include "fileformat.h"
 
 using json = nlohmann::json;
 
+// Score reached by all the robots and area of the particles left in a state
+struct ScoreEntry {
+	double score = 0.0;
+	double remainingArea = 0.0;
+};
+
 class State {
 
 public:
@@ -26,25 +34,35 @@ public:
 
 	State(const std::string &path);
 
+	State(double time, Position worldOrigin, Position worldEnd, std::vector<Robot>
+	robots, std::vector<Particle> particles);
+
 	std::vector<Robot> &getRobots() { return robots; }
 
+	const std::vector<Robot> &getRobots() const { return robots; }
+
 	std::vector<Particle> &getParticles() { return particles; }
 
-	double getTime() { return time; }
+	const std::vector<Particle> &getParticles() const { return particles; }
 
-	Position getWorldOrigin();
+	double getTime() const { return time; }
 
-	Position getWorldEnd();
+	const Position &getWorldOrigin() const { return worldOrigin; }
 
-	void serialize(const std::string &outputPath, const std::string &fileName);
+	const Position &getWorldEnd() const { return worldEnd; }
 
-	void serialize(const std::string &outputPath);
+	void serialize(const std::string &outputPath, const std::string &fileName) const;
+
+	void serialize(const std::string &outputPath, FileFormat format = JSON_PRETTY) const;
 
 	void deserialize(const std::string &fileName);
 
 	friend std::ostream &operator<<(std::ostream &os, const State &s);
 
-	bool isEmpty() { return robots.empty() && particles.empty(); }
+	bool isEmpty() const { return robots.empty() && particles.empty(); }
+
+	// Sum of the robots scores and area of the remaining particles
+	ScoreEntry getScore() const;
 
 private:
 	double time;
@@ -58,4 +76,7 @@ private:
 											 particles)
 };
 
+// State owned by a timeline, its block stays decoded while the pointer lives
+using StatePointer = std::shared_ptr<const State>;
+
 #endif // STATE_H
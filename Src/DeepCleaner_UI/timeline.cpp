@@ -6,15 +6,47 @@ Description :  Implementation of the timeline class
 Compiler : Mingw-w64 g++ 11.2.0
 -----------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include "timeline.h"
 #include "utils.h"
+#include "saxreader.h"
+#include "blockfile.h"
 
-Timeline::Timeline(const std::string &path) {
+StatePointer StatePool::share(State &&state) {
+	json state_j = state;
+	std::string content;
+	json::to_cbor(state_j, content);
+	std::size_t key = std::hash<std::string>()(content);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto range = states.equal_range(key);
+	for (auto pooled = range.first; pooled != range.second;) {
+		StatePointer shared = pooled->second.lock();
+		if (!shared) {
+			pooled = states.erase(pooled);
+			continue;
+		}
+		if (json(*shared) == state_j)
+			return shared;
+		++pooled;
+	}
+	StatePointer shared = std::make_shared<const State>(std::move(state));
+	states.emplace(key, shared);
+	return shared;
+}
+
+static StatePointer shareState(State &&state, StatePool *pool) {
+	if (pool == nullptr)
+		return std::make_shared<const State>(std::move(state));
+	return pool->share(std::move(state));
+}
+
+Timeline::Timeline(const std::string &path, StatePool *pool) {
 	try {
-		deserialize(path);
-		currentState = states.begin();
+		deserialize(path, pool);
+		currentState = 0;
 	}
 	catch (std::exception &e) {
 		std::cerr << e.what() << '\n';
@@ -24,10 +56,10 @@ Timeline::Timeline(const std::string &path) {
 
 std::ostream &operator<<(std::ostream &os, const Timeline &tl) {
 	json tl_j;
-	if (tl.states.empty())
+	if (tl.isEmpty())
 		tl_j = "{ \"states\": null}"_json;
 	else
-		tl_j = tl;
+		tl_j = tl.toJson();
 	std::cout << std::setw(4) << tl_j << '\n';
 	return os;
 }
@@ -37,36 +69,140 @@ Timeline::serialize(const std::string &outputPath, const std::string &fileName)
 	serialize(outputPath + addExtension(fileName, ".tlin"));
 }
 
-void Timeline::serialize(const std::string &outputPath) {
+void Timeline::serialize(const std::string &outputPath, FileFormat format) {
 	std::ofstream ofs;
-	json tl_j = *this;
+	json tl_j = toJson();
 	try {
-		ofs.open(outputPath);
+		ofs.open(outputPath, isBinaryFormat(format) ?
+				 std::ios::out | std::ios::binary : std::ios::out);
 	}
 	catch (std::ios_base::failure &e) {
 		throw "Error creating the file \'" + outputPath + "\' : " + e.what();
 	}
-	ofs << std::setw(4) << tl_j;
+	writeDocument(ofs, tl_j, format);
 	ofs.close();
 }
 
-void Timeline::deserialize(const std::string &inputPath) {
-	std::ifstream f(inputPath);
-	json data = json::parse(f);
-	this->states = data.get<Timeline>().states;
+void Timeline::deserialize(const std::string &inputPath, StatePool *pool) {
+	std::ifstream f(inputPath, std::ios::binary);
+	states.reset();
+	firstState.reset();
+	source.reset();
+	times.clear();
+	scores.clear();
+	if (!BlockReader::isBlockFile(f)) {
+		auto all = std::make_shared<std::vector<State>>();
+		readStates(f, [&all](State &&s) { all->push_back(std::move(s)); });
+		states = all;
+		computeScores();
+		if (!all->empty()) {
+			firstState = shareState(std::move(all->front()), pool);
+			all->front() = State();
+		}
+		return;
+	}
+
+	// Only the index is read, the blocks are decoded when a state is asked
+	source = std::make_unique<BlockSource>();
+	source->file = std::move(f);
+	source->reader = std::make_unique<BlockReader>(source->file);
+	std::size_t first = 0;
+	for (const BlockInfo &info: source->reader->getBlocks()) {
+		source->firstStates.push_back(first);
+		first += info.stateCount;
+	}
+
+	const std::vector<StateSummary> &summaries = source->reader->getSummaries();
+	times.reserve(first);
+	scores.reserve(first);
+	if (summaries.empty()) {
+		// Files written before the summaries are decoded once, without keeping
+		// the states
+		source->reader->readAll([this](State &&s) {
+			times.push_back(s.getTime());
+			scores.push_back(s.getScore());
+		});
+	} else {
+		for (const StateSummary &summary: summaries) {
+			times.push_back(summary.time);
+			scores.push_back({summary.score, summary.remainingArea});
+		}
+	}
+
+	// The first block is decoded once to take out the first state
+	if (first > 0) {
+		std::shared_ptr<std::vector<State>> block = source->decode(0);
+		firstState = shareState(std::move(block->front()), pool);
+		block->front() = State();
+		source->cache.emplace_front(0, std::move(block));
+	}
+}
+
+void Timeline::computeScores() {
+	times.reserve(states->size());
+	scores.reserve(states->size());
+	for (const State &state: *states) {
+		times.push_back(state.getTime());
+		scores.push_back(state.getScore());
+	}
 }
 
-void Timeline::setCurrentState(double time) {
-	if (!this->isEmpty()) {
-		// Search the state before the first one with time bigger than the actual time
-		StateIterator newState = std::prev(std::find_if(states.begin(), states.end
-			(), [=](State s) { return s.getTime() > time; }), 1);
-
-		// Update the current state
-		if (newState != currentState) {
-			currentState = newState;
+json Timeline::toJson() const {
+	json tl_j;
+	json &states_j = tl_j["states"] = json::array();
+	for (std::size_t i = 0; i < times.size(); ++i)
+		states_j.push_back(*getState(i));
+	return tl_j;
+}
+
+StateBlock Timeline::BlockSource::getBlock(std::size_t index) {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto cached = cache.begin(); cached != cache.end(); ++cached) {
+		if (cached->first == index) {
+			cache.splice(cache.begin(), cache, cached);
+			return cached->second;
 		}
 	}
+
+	std::shared_ptr<std::vector<State>> block = decode(index);
+	// The timeline keeps the first state on its own
+	if (index == 0)
+		block->front() = State();
+	cache.emplace_front(index, block);
+	if (cache.size() > CACHED_BLOCKS)
+		cache.pop_back();
+	return block;
+}
+
+std::shared_ptr<std::vector<State>> Timeline::BlockSource::decode(std::size_t index) {
+	auto block = std::make_shared<std::vector<State>>();
+	block->reserve(reader->getBlocks()[index].stateCount);
+	reader->readBlock(index, [&block](State &&s) { block->push_back(std::move(s)); });
+	return block;
+}
+
+std::size_t Timeline::indexAt(double time) const {
+	// Search the state before the first one with time bigger than the given time
+	auto next = std::upper_bound(times.begin(), times.end(), time);
+	return next == times.begin() ? 0 : std::size_t(next - times.begin() - 1);
+}
+
+StatePointer Timeline::getState(std::size_t index) const {
+	if (index == 0)
+		return firstState;
+	if (!source)
+		return StatePointer(states, &(*states)[index]);
+
+	const std::vector<std::size_t> &firstStates = source->firstStates;
+	std::size_t block = std::size_t(std::upper_bound(firstStates.begin(),
+		firstStates.end(), index) - firstStates.begin()) - 1;
+	StateBlock decoded = source->getBlock(block);
+	return StatePointer(decoded, &(*decoded)[index - firstStates[block]]);
+}
+
+void Timeline::setCurrentState(double time) {
+	if (!this->isEmpty())
+		currentState = indexAt(time);
 }
 
 void Timeline::setNextState() {
@@ -79,22 +215,46 @@ void Timeline::setPreviousState() {
 		--currentState;
 }
 
-State *Timeline::getCurrentState() {
-	return &(*currentState);
+StatePointer Timeline::getCurrentState() const {
+	return isEmpty() ? nullptr : getState(currentState);
 }
 
-State *Timeline::getNextState() {
+StatePointer Timeline::getNextState() const {
 	if (!isLastState(currentState))
-		return &(*std::next(currentState, 1));
-	return &(*currentState);
+		return getState(currentState + 1);
+	return getCurrentState();
 }
 
-State *Timeline::getPreviousState() {
+StatePointer Timeline::getPreviousState() const {
 	if (!isFirstState(currentState))
-		return &(*std::prev(currentState, 1));
-	return &(*currentState);
+		return getState(currentState - 1);
+	return getCurrentState();
+}
+
+StatePointer Timeline::getLastState() const {
+	return isEmpty() ? nullptr : getState(times.size() - 1);
+}
+
+StatePointer Timeline::getStateAt(double time) const {
+	if (isEmpty())
+		return nullptr;
+	if (!source)
+		return getState(indexAt(time));
+
+	// Only the block holding the time is decoded, the wanted state is the one
+	// before the first state strictly after the time
+	std::size_t block = source->reader->findBlock(time);
+	std::size_t first = source->firstStates[block];
+	auto begin = times.begin() + std::ptrdiff_t(first);
+	auto next = std::upper_bound(begin, begin + source->reader->getBlocks()[block]
+		.stateCount, time);
+	std::size_t index = next == begin ? first : std::size_t(next - times.begin()) - 1;
+	if (index == 0)
+		return firstState;
+	StateBlock decoded = source->getBlock(block);
+	return StatePointer(decoded, &(*decoded)[index - first]);
 }
 
-State *Timeline::getLastState() {
-	return &(*(states.end() - 1));
+double Timeline::getEndTime() const {
+	return times.empty() ? 0.0 : times.back();
 }
@@ -2,28 +2,57 @@
 File name : timeline.h
 Author(s) : G. Courbat, J. Streckeisen, T. Van Hove
 Creation date : 22.08.2022
-Description :  Header of the class handling the Timeline objects
+Description :  Header of the class handling the Timeline objects. A compressed
+timeline stays open and its blocks are decoded when a state is asked, only the
+times and the scores of all its states are kept in memory
 Compiler : Mingw-w64 g++ 11.2.0
 -----------------------------------------------------------------------------*/
 
 #ifndef TIMELINE_H
 #define TIMELINE_H
 
+#include <cstddef>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <string>
 #include "state.h"
+#include "blockfile.h"
 #include "json.hpp"
+#include "fileformat.h"
 
 using json = nlohmann::json;
-using StateIterator = std::vector<State>::iterator;
+using StateBlock = std::shared_ptr<const std::vector<State>>;
+
+// Decoded blocks kept by a compressed timeline, the least recently used first
+// dropped
+const std::size_t CACHED_BLOCKS = 4;
+
+// Initial states shared by the timelines starting from the same scenario,
+// found by the hash of their content
+class StatePool {
+
+public:
+	// The pooled state equal to the given one, added if it is new (thread safe)
+	StatePointer share(State &&state);
+
+private:
+	std::mutex mutex;
+	std::unordered_multimap<std::size_t, std::weak_ptr<const State>> states;
+};
 
 class Timeline {
 
 public:
-	Timeline() : states(std::vector<State>()) {}
+	Timeline() {}
 
-	//The full path file (with extension) must be given
-	Timeline(const std::string &path);
+	//The full path file (with extension) must be given, the first state is
+	//shared with the other timelines of the pool if one is given
+	Timeline(const std::string &path, StatePool *pool = nullptr);
 
 	void setCurrentState(double time);
 
@@ -31,34 +60,74 @@ public:
 
 	void setPreviousState();
 
-	State *getCurrentState();
+	StatePointer getCurrentState() const;
 
-	State *getNextState();
+	StatePointer getNextState() const;
 
-	State *getPreviousState();
+	StatePointer getPreviousState() const;
 
-	State *getLastState();
+	StatePointer getLastState() const;
+
+	// Read-only lookup that does not move the current state (thread safe)
+	StatePointer getStateAt(double time) const;
+
+	double getEndTime() const;
+
+	// Known when loading, one entry per state
+	const std::vector<double> &getTimes() const { return times; }
+
+	// Computed once when loading, one entry per state
+	const std::vector<ScoreEntry> &getScores() const { return scores; }
+
+	const ScoreEntry &getCurrentScore() const { return scores[currentState]; }
+
+	// Score of the state displayed at the given time
+	const ScoreEntry &getScoreAt(double time) const {
+		return scores[indexAt(time)];
+	}
 
 	friend std::ostream &operator<<(std::ostream &os, const Timeline &tl);
 
-	bool isLastState(StateIterator state) { return state == (states.end() - 1); }
+	bool isLastState(std::size_t state) const { return state + 1 == times.size(); }
 
-	bool isFirstState(StateIterator state) { return state == (states.begin()); }
+	bool isFirstState(std::size_t state) const { return state == 0; }
 
-	bool isEmpty() { return states.empty(); }
+	bool isEmpty() const { return times.empty(); }
 
 	void serialize(const std::string &outputPath, const std::string &fileName);
 
-	void serialize(const std::string &outputPath);
+	void serialize(const std::string &outputPath, FileFormat format = JSON_PRETTY);
 
-	void deserialize(const std::string &inputPath);
+	void deserialize(const std::string &inputPath, StatePool *pool = nullptr);
 
 private:
-	std::vector<State> states;
-	StateIterator currentState;
+	// Compressed file read on demand, shared by the threads rendering it
+	struct BlockSource {
+		std::ifstream file;
+		std::unique_ptr<BlockReader> reader;
+		std::vector<std::size_t> firstStates; // index of the first state per block
+		std::list<std::pair<std::size_t, StateBlock>> cache; // most recent first
+		std::mutex mutex;
+
+		StateBlock getBlock(std::size_t index);
+		std::shared_ptr<std::vector<State>> decode(std::size_t index);
+	};
+
+	// Every state of a plain file, nothing for a compressed one. The first
+	// state is only kept by firstState
+	StateBlock states;
+	StatePointer firstState;
+	std::unique_ptr<BlockSource> source;
+	std::vector<double> times;
+	std::vector<ScoreEntry> scores;
+	std::size_t currentState = 0;
+
+	std::size_t indexAt(double time) const;
+	StatePointer getState(std::size_t index) const;
+	json toJson() const;
+
+	void computeScores();
 	std::string fileExtension = ".tlin";
-
-	NLOHMANN_DEFINE_TYPE_INTRUSIVE(Timeline, states)
 };
 
 #endif // TIMELINE_H
@@ -54,6 +54,24 @@ void updateCircCoordinate(Robot &robot, double time) {
 	robot.setAngle(toDeg(angle));
 }
 
+void advanceRobot(Robot &robot, double deltaTime) {
+	if (equal(robot.getLeftSpeed(), robot.getRightSpeed())) {
+		// Straight line (or idle)
+		if (!equal(robot.getLeftSpeed(), 0.0)) {
+			robot.setPosition(
+				updateLinCoordinate(robot.getPosition(), robot.getLeftSpeed(),
+										  robot.getAngle(), deltaTime));
+		}
+	} else if (robot.getLeftSpeed() == -robot.getRightSpeed()) {
+		// Rotation on itself
+		robot.setAngle(toDeg(
+			updateAngle(robot.getAngle(), robot.getRadius(), robot.getLeftSpeed(),
+							robot.getRightSpeed(), deltaTime)));
+	} else {
+		updateCircCoordinate(robot, deltaTime);
+	}
+}
+
 double updateAngle(double angle, double radius, double leftSpeed, double rightSpeed,
 						 double deltaTime) {
 	double omega = angularSpeed(radius, leftSpeed, rightSpeed);
@@ -15,6 +15,8 @@ deltaTime);
 
 void updateCircCoordinate(Robot &robot, double time);
 
+void advanceRobot(Robot &robot, double deltaTime);
+
 double toRad(double deg);
 
 double toDeg(double rad);